@@ -0,0 +1,489 @@
+#include "autoplayer.h"
+#include "game.h"
+#include "physics.h"
+#include "threadPool.h"
+
+#include "common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+
+#define DEFAULT_LAUNCHES_PER_LEVEL 32
+#define DEFAULT_MAX_GAME_TIME      10800
+
+// Pad aims to hit the ball this far from its center, as a fraction of the pad width, for the policies that aim off center
+#define MAX_AIM_OFFSET 0.4f
+
+// Late pad only starts following the ball once it is this far down the window, as a fraction of the window height
+#define LATE_PAD_REACTION_HEIGHT 0.6f
+
+// Most unreachable bricks listed by position for a single level, the rest are only counted
+#define MAX_LISTED_UNREACHABLE_BRICKS 16
+
+/// <summary>
+/// Ways the simulated player moves the pad while the ball is in play. Every policy is played from every launch position. CENTER hits the ball with the
+/// center of the pad, EDGES with its edges in turn, RANDOM at a random spot after every pad bounce, and LATE like RANDOM but only once the ball is low.
+/// </summary>
+enum class PadPolicy { CENTER, EDGES, RANDOM, LATE };
+
+#define PAD_POLICY_COUNT 4
+
+/// <summary>
+/// Names of the pad policies, indexed by the policy.
+/// </summary>
+static const char* const PAD_POLICY_NAMES[PAD_POLICY_COUNT] = {"center", "edges", "random", "late"};
+
+/// <summary>
+/// Outcome of a single analyzed game.
+/// </summary>
+struct RunResult {
+    /// <summary>
+    /// True if all breakable bricks were destroyed.
+    /// </summary>
+    bool cleared = false;
+
+    /// <summary>
+    /// Simulated time spent with the ball on the pad or in play, in microseconds.
+    /// </summary>
+    uint64_t playTime = 0;
+
+    /// <summary>
+    /// Number of times a ball was released from the pad.
+    /// </summary>
+    uint32_t launches = 0;
+
+    /// <summary>
+    /// Number of lives lost.
+    /// </summary>
+    uint32_t livesLost = 0;
+
+    /// <summary>
+    /// Number of times a ball bounced off the pad.
+    /// </summary>
+    uint32_t padBounces = 0;
+
+    /// <summary>
+    /// Number of times a ball bounced off the walls.
+    /// </summary>
+    uint32_t wallBounces = 0;
+
+    /// <summary>
+    /// Number of times a ball bounced off the bricks.
+    /// </summary>
+    uint32_t brickBounces = 0;
+};
+
+/// <summary>
+/// Results of all games played on a single level with a single pad policy.
+/// </summary>
+struct PolicyStatistics {
+    /// <summary>
+    /// Number of games played.
+    /// </summary>
+    uint32_t gameCount = 0;
+
+    /// <summary>
+    /// Number of games in which the level was cleared.
+    /// </summary>
+    uint32_t clearedCount = 0;
+
+    /// <summary>
+    /// Sum of play times of the cleared games, in microseconds.
+    /// </summary>
+    uint64_t clearTimeSum = 0;
+
+    /// <summary>
+    /// Shortest play time of a cleared game, in microseconds.
+    /// </summary>
+    uint64_t clearTimeMin = UINT64_MAX;
+
+    /// <summary>
+    /// Longest play time of a cleared game, in microseconds.
+    /// </summary>
+    uint64_t clearTimeMax = 0;
+
+    /// <summary>
+    /// Sum of the ball releases in all games.
+    /// </summary>
+    uint64_t launchSum = 0;
+
+    /// <summary>
+    /// Sum of the lives lost in all games.
+    /// </summary>
+    uint64_t livesLostSum = 0;
+
+    /// <summary>
+    /// Sum of the pad bounces in all games.
+    /// </summary>
+    uint64_t padBounceSum = 0;
+
+    /// <summary>
+    /// Sum of the wall bounces in all games.
+    /// </summary>
+    uint64_t wallBounceSum = 0;
+
+    /// <summary>
+    /// Sum of the brick bounces in all games.
+    /// </summary>
+    uint64_t brickBounceSum = 0;
+
+    /// <summary>
+    /// Adds the result of a game to the statistics.
+    /// </summary>
+    /// <param name="result">Result of the game.</param>
+    void add(const RunResult& result) {
+        ++gameCount;
+        if (result.cleared) {
+            ++clearedCount;
+            clearTimeSum += result.playTime;
+            clearTimeMin = std::min(clearTimeMin, result.playTime);
+            clearTimeMax = std::max(clearTimeMax, result.playTime);
+        }
+        launchSum += result.launches;
+        livesLostSum += result.livesLost;
+        padBounceSum += result.padBounces;
+        wallBounceSum += result.wallBounces;
+        brickBounceSum += result.brickBounces;
+    }
+
+    /// <summary>
+    /// Adds the statistics gathered by another thread or for another policy.
+    /// </summary>
+    /// <param name="other">Statistics to be added.</param>
+    void merge(const PolicyStatistics& other) {
+        gameCount += other.gameCount;
+        clearedCount += other.clearedCount;
+        clearTimeSum += other.clearTimeSum;
+        clearTimeMin = std::min(clearTimeMin, other.clearTimeMin);
+        clearTimeMax = std::max(clearTimeMax, other.clearTimeMax);
+        launchSum += other.launchSum;
+        livesLostSum += other.livesLostSum;
+        padBounceSum += other.padBounceSum;
+        wallBounceSum += other.wallBounceSum;
+        brickBounceSum += other.brickBounceSum;
+    }
+};
+
+/// <summary>
+/// Everything a single thread needs to analyze levels. Levels hold the mutable game state, so every thread has its own copy.
+/// </summary>
+struct AnalysisWorker {
+    /// <summary>
+    /// Thread's own copy of all levels.
+    /// </summary>
+    std::vector<std::unique_ptr<Level>> levels;
+
+    /// <summary>
+    /// Game played on the thread's levels.
+    /// </summary>
+    std::unique_ptr<Game> game;
+
+    /// <summary>
+    /// Snapshots of the game at the start of each level, restored to start every game instead of loading the level again.
+    /// </summary>
+    std::vector<GameSnapshot> levelStarts;
+
+    /// <summary>
+    /// Statistics gathered by the thread, one entry per level and pad policy, at index level * PAD_POLICY_COUNT + policy.
+    /// </summary>
+    std::vector<PolicyStatistics> statistics;
+
+    /// <summary>
+    /// Number of times each brick was hit in the games of the thread, one vector per level indexed like the bricks.
+    /// </summary>
+    std::vector<std::vector<uint64_t>> brickHits;
+};
+
+/// <summary>
+/// Plays a game on a single level until the level is cleared, all lives are lost or the time runs out. Every ball is released with the pad at the launch
+/// position, so the launch direction is the one the game picks for that position. While the ball is in play the pad follows the lowest ball as the
+/// policy dictates, steered and released the same way the autoplayer does it.
+/// </summary>
+/// <param name="game">Game to be played.</param>
+/// <param name="levelStart">Snapshot of the game at the start of the level to be played.</param>
+/// <param name="launchPosition">Position of the launch between the leftmost and the rightmost pad position, from 0.0f to 1.0f.</param>
+/// <param name="policy">Way the pad follows the ball.</param>
+/// <param name="seed">Seed of the random choices made by the RANDOM and LATE policies.</param>
+/// <param name="maxTime">Maximum simulated duration of the game in microseconds.</param>
+/// <param name="brickHits">Hit counts of the bricks of the level, incremented for every brick bounce.</param>
+/// <returns>Outcome of the game.</returns>
+static RunResult playGame(Game& game, const GameSnapshot& levelStart, const float& launchPosition, const PadPolicy& policy, const uint32_t& seed,
+                          const uint64_t& maxTime, std::vector<uint64_t>& brickHits) {
+    const uint32_t tickTime = 1'000'000 / PHYSICS_TICK_RATE;
+
+    game.restoreSnapshot(levelStart);
+    const Level& level = *game.getCurrentLevel();
+
+    const std::vector<Instance>& instances      = level.getInstances();
+    const float                  padWidth       = instances[PAD_INDEX].scale.x;
+    const float                  releaseTarget  = Autoplayer::getReleaseTarget(level, launchPosition);
+    const float                  reactionHeight = LATE_PAD_REACTION_HEIGHT * level.getWindowDimensions().y;
+
+    std::mt19937                          random(seed);
+    std::uniform_real_distribution<float> aimDistribution(-MAX_AIM_OFFSET * padWidth, MAX_AIM_OFFSET * padWidth);
+
+    float aimOffset = 0.0f;
+    if (policy == PadPolicy::EDGES) {
+        aimOffset = MAX_AIM_OFFSET * padWidth;
+    } else if (policy == PadPolicy::RANDOM || policy == PadPolicy::LATE) {
+        aimOffset = aimDistribution(random);
+    }
+
+    RunResult result;
+    GameInput input;
+    uint64_t  time = 0;
+    while (time < maxTime) {
+        const GameState state = game.getGameState();
+        if (state == GameState::WIN_LEVEL || state == GameState::LOSE_GAME) {
+            result.cleared = state == GameState::WIN_LEVEL;
+            break;
+        }
+
+        input.padControl = 0.0f;
+        input.release    = false;
+        if (state == GameState::BALL_ATTACHED) {
+            input.padControl = Autoplayer::steerPad(level, releaseTarget, tickTime);
+            input.release    = Autoplayer::isAtReleaseTarget(level, releaseTarget);
+            result.launches += input.release ? 1 : 0;
+        } else if (state == GameState::PLAYING) {
+            uint32_t lowestBall = UINT32_MAX;
+            for (uint32_t i = 0; i < level.getBallCount(); ++i) {
+                if (level.isBallActive(i) &&
+                    (lowestBall == UINT32_MAX || instances[level.getBallIndex() + i].position.y > instances[level.getBallIndex() + lowestBall].position.y)) {
+                    lowestBall = i;
+                }
+            }
+
+            const glm::vec2& ballPosition = instances[level.getBallIndex() + lowestBall].position;
+            if (policy != PadPolicy::LATE || ballPosition.y > reactionHeight) {
+                input.padControl = Autoplayer::steerPad(level, ballPosition.x + aimOffset, tickTime);
+            }
+        }
+
+        game.tick(tickTime, input);
+        time += tickTime;
+        if (state == GameState::BALL_ATTACHED || state == GameState::PLAYING) {
+            result.playTime += tickTime;
+        }
+
+        const CollisionEventRing& collisionEvents = game.getCollisionEvents();
+        for (uint32_t i = 0; i < collisionEvents.getCount(); ++i) {
+            switch (collisionEvents[i].type) {
+                case CollisionType::PAD:
+                    ++result.padBounces;
+                    if (policy == PadPolicy::EDGES) {
+                        aimOffset = -aimOffset;
+                    } else if (policy == PadPolicy::RANDOM || policy == PadPolicy::LATE) {
+                        aimOffset = aimDistribution(random);
+                    }
+                    break;
+                case CollisionType::WALL:
+                    ++result.wallBounces;
+                    break;
+                case CollisionType::BRICK:
+                    ++result.brickBounces;
+                    ++brickHits[collisionEvents[i].hitBrickIndex];
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (game.getLifeCount() < START_LIFE_COUNT - result.livesLost) {
+            ++result.livesLost;
+        }
+    }
+
+    return result;
+}
+
+/// <summary>
+/// Prints a row of the policy table.
+/// </summary>
+/// <param name="name">Name of the row.</param>
+/// <param name="statistics">Statistics printed in the row.</param>
+static void printStatistics(const char* name, const PolicyStatistics& statistics) {
+    const double games        = std::max(statistics.gameCount, 1u);
+    const double clearedGames = std::max(statistics.clearedCount, 1u);
+    printf("  %-10s %8u %7.1f%% %9.1fs %9.1fs %9.1fs %8.2f %8.2f %8.1f %8.1f %8.1f\n", name, statistics.gameCount,
+           100.0 * statistics.clearedCount / games, MICROSECONDS_TO_SECONDS(statistics.clearTimeSum / clearedGames),
+           statistics.clearedCount ? MICROSECONDS_TO_SECONDS(statistics.clearTimeMin) : 0.0f, MICROSECONDS_TO_SECONDS(statistics.clearTimeMax),
+           statistics.launchSum / games, statistics.livesLostSum / games, statistics.padBounceSum / games, statistics.wallBounceSum / games,
+           statistics.brickBounceSum / games);
+}
+
+/// <summary>
+/// Prints the command line options.
+/// </summary>
+static void printUsage() {
+    printf("Usage: breakout_analyze [options]\n"
+           "  --launches <count>   Launch positions played per level and pad policy (default %d)\n"
+           "  --threads <count>    Number of threads, 0 for one per core (default 0)\n"
+           "  --seed <value>       Seed of the random pad policies (default 0)\n"
+           "  --max-time <seconds> Simulated time after which a game is given up (default %d)\n"
+           "  --levels <folder>    Folder holding the level files (default .%s)\n"
+           "  --fixed-point        Resolves physics in fixed point math, reproducible on any machine\n"
+           "  --check-reachable    Fails if a level has a breakable brick that no game hit\n",
+           DEFAULT_LAUNCHES_PER_LEVEL, DEFAULT_MAX_GAME_TIME, LEVEL_FOLDER);
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t    launchesPerLevel = DEFAULT_LAUNCHES_PER_LEVEL;
+    uint32_t    threadCount      = 0;
+    uint32_t    seed             = 0;
+    uint32_t    maxGameTime      = DEFAULT_MAX_GAME_TIME;
+    std::string levelFolder      = std::filesystem::current_path().string() + LEVEL_FOLDER;
+    PhysicsMode physicsMode      = PhysicsMode::FLOATING_POINT;
+    bool        checkReachable   = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && !strcmp(argv[i], "--launches")) {
+            launchesPerLevel = std::max(static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)), 1u);
+        } else if (i + 1 < argc && !strcmp(argv[i], "--threads")) {
+            threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--seed")) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--max-time")) {
+            maxGameTime = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--levels")) {
+            levelFolder = argv[++i];
+        } else if (!strcmp(argv[i], "--fixed-point")) {
+            physicsMode = PhysicsMode::FIXED_POINT;
+        } else if (!strcmp(argv[i], "--check-reachable")) {
+            checkReachable = true;
+        } else {
+            printUsage();
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    try {
+        std::vector<std::string> levelPaths;
+        for (const auto& file : std::filesystem::directory_iterator(levelFolder)) {
+            if (file.path().extension() == ".xml") {
+                levelPaths.push_back(file.path().string());
+            }
+        }
+        std::sort(levelPaths.begin(), levelPaths.end());
+
+        if (levelPaths.empty()) {
+            char error[512];
+            snprintf(error, sizeof(error), "No levels found in %s!", levelFolder.c_str());
+            throw std::runtime_error(error);
+        }
+
+        ThreadPool threadPool(threadCount);
+
+        std::vector<AnalysisWorker> workers(threadPool.getThreadCount());
+        for (AnalysisWorker& worker : workers) {
+            for (const std::string& levelPath : levelPaths) {
+                worker.levels.push_back(std::make_unique<Level>(levelPath.c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, nullptr, nullptr, nullptr));
+                worker.brickHits.emplace_back(worker.levels.back()->getTotalBrickCount(), 0);
+            }
+            worker.game = std::make_unique<Game>(worker.levels, physicsMode);
+            worker.levelStarts.resize(levelPaths.size());
+            for (uint32_t i = 0; i < levelPaths.size(); ++i) {
+                worker.game->initializeLevel(START_LIFE_COUNT, 0, i);
+                worker.game->captureSnapshot(worker.levelStarts[i]);
+            }
+            worker.statistics.resize(levelPaths.size() * PAD_POLICY_COUNT);
+        }
+
+        printf("Analyzing %u launch positions with %d pad policies on each of %zu levels on %u threads\n\n", launchesPerLevel, PAD_POLICY_COUNT,
+               levelPaths.size(), threadPool.getThreadCount());
+
+        const uint32_t gamesPerLevel = launchesPerLevel * PAD_POLICY_COUNT;
+        const uint32_t gameCount     = gamesPerLevel * static_cast<uint32_t>(levelPaths.size());
+        const auto     start         = std::chrono::high_resolution_clock::now();
+
+        threadPool.run(gameCount, [&](const uint32_t& taskIndex, const uint32_t& threadIndex) {
+            AnalysisWorker& worker     = workers[threadIndex];
+            const uint32_t  levelIndex = taskIndex / gamesPerLevel;
+            const uint32_t  launch     = taskIndex % gamesPerLevel / PAD_POLICY_COUNT;
+            const uint32_t  policy     = taskIndex % PAD_POLICY_COUNT;
+            const float     position   = (launch + 0.5f) / launchesPerLevel;
+
+            RunResult result = playGame(*worker.game, worker.levelStarts[levelIndex], position, static_cast<PadPolicy>(policy), seed * gameCount + taskIndex,
+                                        SECONDS_TO_MICROSECONDS(static_cast<uint64_t>(maxGameTime)), worker.brickHits[levelIndex]);
+            worker.statistics[levelIndex * PAD_POLICY_COUNT + policy].add(result);
+        });
+
+        const double totalTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        uint32_t unreachableLevelCount = 0;
+        for (uint32_t i = 0; i < levelPaths.size(); ++i) {
+            printf("%s\n", std::filesystem::path(levelPaths[i]).filename().string().c_str());
+            printf("  %-10s %8s %8s %10s %10s %10s %8s %8s %8s %8s %8s\n", "policy", "games", "cleared", "clear avg", "clear min", "clear max", "launches",
+                   "lives", "pad", "wall", "brick");
+
+            PolicyStatistics levelStatistics;
+            for (uint32_t policy = 0; policy < PAD_POLICY_COUNT; ++policy) {
+                PolicyStatistics statistics;
+                for (const AnalysisWorker& worker : workers) {
+                    statistics.merge(worker.statistics[i * PAD_POLICY_COUNT + policy]);
+                }
+                printStatistics(PAD_POLICY_NAMES[policy], statistics);
+                levelStatistics.merge(statistics);
+            }
+            printStatistics("all", levelStatistics);
+
+            // Loading the level again restores the bricks the games destroyed, so the breakable ones can be told apart
+            Level& level = *workers[0].levels[i];
+            workers[0].game->initializeLevel(START_LIFE_COUNT, 0, i);
+            const Instance* const bricks = level.getBricksPtr();
+            const BrickGrid&      grid   = level.getBrickGrid();
+
+            uint32_t breakableCount   = 0;
+            uint32_t unreachableCount = 0;
+            for (uint32_t brick = 0; brick < level.getTotalBrickCount(); ++brick) {
+                if (bricks[brick].health == 0 || bricks[brick].maxHealth == UINT32_MAX) {
+                    continue;
+                }
+
+                ++breakableCount;
+                uint64_t hits = 0;
+                for (const AnalysisWorker& worker : workers) {
+                    hits += worker.brickHits[i][brick];
+                }
+
+                if (hits == 0) {
+                    if (unreachableCount < MAX_LISTED_UNREACHABLE_BRICKS && brick < grid.rowCount * grid.columnCount) {
+                        printf("  unreachable brick at row %u, column %u\n", brick / grid.columnCount, brick % grid.columnCount);
+                    } else if (unreachableCount < MAX_LISTED_UNREACHABLE_BRICKS) {
+                        const glm::vec2 corner = level.getInstances()[BRICK_START_INDEX + brick].position - 0.5f * bricks[brick].scale;
+                        printf("  unreachable brick off the grid at %.0f, %.0f\n", corner.x, corner.y);
+                    }
+                    ++unreachableCount;
+                }
+            }
+            printf("  %u of %u breakable bricks never hit\n\n", unreachableCount, breakableCount);
+            unreachableLevelCount += unreachableCount > 0 ? 1 : 0;
+        }
+
+        uint64_t droppedEventCount = 0;
+        for (const AnalysisWorker& worker : workers) {
+            droppedEventCount += worker.game->getCollisionEvents().getDroppedCount();
+        }
+        printf("%u games in %.2fs, %.1f games/s\n", gameCount, totalTime, gameCount / totalTime);
+        printf("%llu collision events dropped\n", static_cast<unsigned long long>(droppedEventCount));
+
+        if (droppedEventCount > 0) {
+            fprintf(stderr, "Collision events were dropped, the games did not follow the rules!\n");
+            return -1;
+        }
+        if (checkReachable && unreachableLevelCount > 0) {
+            fprintf(stderr, "%u levels have breakable bricks that no game hit!\n", unreachableLevelCount);
+            return -1;
+        }
+    } catch (std::runtime_error e) {
+        fprintf(stderr, "%s\n", e.what());
+        return -1;
+    }
+
+    return 0;
+}
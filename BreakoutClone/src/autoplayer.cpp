@@ -0,0 +1,96 @@
+#include "autoplayer.h"
+
+#include <algorithm>
+
+Autoplayer::Autoplayer(const uint32_t& seed) : m_random(seed) {}
+
+void Autoplayer::play(const Game& game, const uint32_t& tickTime, GameInput& input) {
+    const GameState& state = game.getGameState();
+    const Level&     level = *game.getCurrentLevel();
+
+    const std::vector<Instance>& instances = level.getInstances();
+    const float                  padWidth  = instances[PAD_INDEX].scale.x;
+
+    std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+    if (state == GameState::BALL_ATTACHED && m_previousGameState != GameState::BALL_ATTACHED) {
+        m_releasePosition = unitDistribution(m_random);
+    }
+    m_previousGameState = state;
+
+    for (uint32_t i = 0; i < game.getCollisionEvents().getCount(); ++i) {
+        if (game.getCollisionEvents()[i].type == CollisionType::PAD) {
+            m_aimOffset = AUTOPLAYER_MAX_AIM_OFFSET * (2.0f * unitDistribution(m_random) - 1.0f);
+        }
+    }
+
+    input.padControl = 0.0f;
+    input.release    = false;
+    switch (state) {
+        case GameState::BALL_ATTACHED: {
+            const float releaseTarget = getReleaseTarget(level, m_releasePosition);
+            input.padControl          = steerPad(level, releaseTarget, tickTime);
+            input.release             = isAtReleaseTarget(level, releaseTarget);
+            break;
+        }
+        case GameState::PLAYING: {
+            // Ball coming down closest to the pad lands first, with none coming down the lowest ball does
+            const std::vector<glm::vec2>& ballDirections = game.getBallDirections();
+
+            uint32_t targetBall    = UINT32_MAX;
+            bool     targetFalling = false;
+            for (uint32_t i = 0; i < level.getBallCount(); ++i) {
+                if (!level.isBallActive(i)) {
+                    continue;
+                }
+
+                const bool falling = ballDirections[i].y > 0.0f;
+                if (targetBall == UINT32_MAX || falling > targetFalling ||
+                    (falling == targetFalling && instances[level.getBallIndex() + i].position.y > instances[level.getBallIndex() + targetBall].position.y)) {
+                    targetBall    = i;
+                    targetFalling = falling;
+                }
+            }
+
+            if (targetBall == UINT32_MAX) {
+                break;
+            }
+
+            // Ball sunk to the height of the pad cannot be hit anymore, the pad makes way instead of pinning it against its top edge
+            const glm::vec2& padPosition  = instances[PAD_INDEX].position;
+            const glm::vec2& ballPosition = instances[level.getBallIndex() + targetBall].position;
+            const float      ballRadius   = 0.5f * instances[level.getBallIndex() + targetBall].scale.x;
+            if (ballPosition.y > padPosition.y - 0.5f * instances[PAD_INDEX].scale.y - ballRadius - EPSILON) {
+                const float clearance = 0.5f * padWidth + 2.0f * ballRadius;
+                input.padControl      = steerPad(level, ballPosition.x + (ballPosition.x > padPosition.x ? -clearance : clearance), tickTime);
+            } else if (targetFalling) {
+                input.padControl = steerPad(level, game.predictBallLanding(targetBall) + m_aimOffset * padWidth, tickTime);
+            } else {
+                input.padControl = steerPad(level, ballPosition.x + m_aimOffset * padWidth, tickTime);
+            }
+            break;
+        }
+        case GameState::RESTART_SCREEN:
+        case GameState::WIN_GAME:
+            input.release = true;
+            break;
+        default:
+            break;
+    }
+}
+
+float Autoplayer::steerPad(const Level& level, const float& targetX, const uint32_t& tickTime) {
+    float padStep = level.getBasePadSpeed() * tickTime;
+    return std::clamp((targetX - level.getInstances()[PAD_INDEX].position.x) / padStep, -1.0f, 1.0f);
+}
+
+float Autoplayer::getReleaseTarget(const Level& level, const float& releasePosition) {
+    const std::vector<Instance>& instances = level.getInstances();
+    const float                  padWidth  = instances[PAD_INDEX].scale.x;
+    const float                  leftEdge  = instances[LEFT_WALL_INDEX].scale.x + 0.5f * padWidth;
+    const float                  rightEdge = instances[RIGHT_WALL_INDEX].position.x - 0.5f * instances[RIGHT_WALL_INDEX].scale.x - 0.5f * padWidth;
+    return leftEdge + releasePosition * (rightEdge - leftEdge);
+}
+
+bool Autoplayer::isAtReleaseTarget(const Level& level, const float& releaseTarget) {
+    return std::abs(releaseTarget - level.getInstances()[PAD_INDEX].position.x) < AUTOPLAYER_RELEASE_TOLERANCE;
+}
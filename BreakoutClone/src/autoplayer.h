@@ -0,0 +1,81 @@
+#pragma once
+
+#include "game.h"
+
+#include "common.h"
+
+#include <random>
+
+// Pad aims to hit the ball this far from its center, as a fraction of the pad width, picked at random after each pad bounce
+#define AUTOPLAYER_MAX_AIM_OFFSET 0.4f
+
+// Ball is released once the pad center is this close to the release position, in pixels
+#define AUTOPLAYER_RELEASE_TOLERANCE 1.0f
+
+/// <summary>
+/// Plays the game in place of the player, so the game can be left running unattended. The pad is moved to where the ball closest to it is predicted to
+/// land, hitting it with a random spot of the pad so the ball spreads across the level, balls are released from random positions and new games are started
+/// on the end screens.
+/// </summary>
+class Autoplayer {
+  public:
+    /// <summary>
+    /// Creates the autoplayer.
+    /// </summary>
+    /// <param name="seed">Seed of the random choices made by the autoplayer.</param>
+    Autoplayer(const uint32_t& seed);
+
+    /// <summary>
+    /// Decides the input of the next simulation step. Pad control and release are overwritten, quitting is left to the player.
+    /// </summary>
+    /// <param name="game">Game being played, after its last simulation step.</param>
+    /// <param name="tickTime">Duration of the simulation step.</param>
+    /// <param name="input">Input of the next simulation step.</param>
+    void play(const Game& game, const uint32_t& tickTime, GameInput& input);
+
+    /// <summary>
+    /// Calculates the pad input that moves the pad towards the target position, slowing down to stop at it.
+    /// </summary>
+    /// <param name="level">Level being played.</param>
+    /// <param name="targetX">X coordinate the pad center should move to.</param>
+    /// <param name="tickTime">Duration of the simulation step.</param>
+    /// <returns>Pad input for the next simulation step.</returns>
+    static float steerPad(const Level& level, const float& targetX, const uint32_t& tickTime);
+
+    /// <summary>
+    /// Calculates where the pad center has to be to release the ball from a position within the pad's range.
+    /// </summary>
+    /// <param name="level">Level being played.</param>
+    /// <param name="releasePosition">Fraction of the pad's range, 0.0f at the left wall and 1.0f at the right wall.</param>
+    /// <returns>X coordinate of the pad center.</returns>
+    static float getReleaseTarget(const Level& level, const float& releasePosition);
+
+    /// <summary>
+    /// Checks whether the pad is close enough to the release position for the ball to be released.
+    /// </summary>
+    /// <param name="level">Level being played.</param>
+    /// <param name="releaseTarget">X coordinate of the pad center the ball is released at.</param>
+    /// <returns>True if the ball should be released.</returns>
+    static bool isAtReleaseTarget(const Level& level, const float& releaseTarget);
+
+  private:
+    /// <summary>
+    /// Source of the random choices.
+    /// </summary>
+    std::mt19937 m_random;
+
+    /// <summary>
+    /// Offset of the spot the pad aims to hit the ball with from the pad center, as a fraction of the pad width.
+    /// </summary>
+    float m_aimOffset = 0.0f;
+
+    /// <summary>
+    /// Fraction of the pad's range the ball is released from, 0.0f at the left wall and 1.0f at the right wall.
+    /// </summary>
+    float m_releasePosition = 0.5f;
+
+    /// <summary>
+    /// Game state of the previous simulation step, a new release position is picked every time the game enters GameState::BALL_ATTACHED.
+    /// </summary>
+    GameState m_previousGameState = GameState::BEGIN_LEVEL;
+};
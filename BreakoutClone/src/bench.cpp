@@ -0,0 +1,934 @@
+#include "game.h"
+#include "level.h"
+#include "physics.h"
+
+#include "common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define DEFAULT_CASE_COUNT   1'000'000
+#define DEFAULT_REPEAT_COUNT 10
+#define DEFAULT_STEP_COUNT   100'000
+#define DEFAULT_BALL_COUNT   1
+
+// Untimed steps run on every board before the measurement, so the caches and the branch predictors are warm
+#define WARMUP_STEP_COUNT 1'000
+
+// Pad aims to hit the ball this far from its center, as a fraction of the pad width, picked at random after each pad bounce
+#define MAX_AIM_OFFSET 0.4f
+
+// Largest sideways component of the direction balls are launched in, relative to the upward component
+#define MAX_LAUNCH_SLOPE 0.7f
+
+// Velocity of the rows of the moving boards in play area widths per second
+#define BENCH_ROW_VELOCITY 0.2f
+
+// Difference in the collision parameter and the reflected direction within which results of the two versions of a test count as the same
+#define AGREEMENT_TOLERANCE 0.0001f
+
+// Ball radius and the largest distance traveled in a single sub-step of the generated cases
+#define CASE_BALL_RADIUS  15.0f
+#define CASE_MAX_DISTANCE 60.0f
+
+/// <summary>
+/// Single sweep against the walls, the pad or a brick.
+/// </summary>
+struct CollisionCase {
+    /// <summary>
+    /// Start point of the sweep.
+    /// </summary>
+    glm::vec2 start;
+
+    /// <summary>
+    /// Direction of the sweep, normalized.
+    /// </summary>
+    glm::vec2 direction;
+
+    /// <summary>
+    /// Length of the sweep.
+    /// </summary>
+    float distance;
+
+    /// <summary>
+    /// Center of the rectangle swept against, the pad or the brick.
+    /// </summary>
+    glm::vec2 rectCenter;
+
+    /// <summary>
+    /// Dimensions of the rectangle swept against, the pad or the brick.
+    /// </summary>
+    glm::vec2 rectDimensions;
+};
+
+/// <summary>
+/// Outcome of a single test on a single case.
+/// </summary>
+struct CollisionResult {
+    /// <summary>
+    /// True if the test found a collision.
+    /// </summary>
+    bool hit = false;
+
+    /// <summary>
+    /// Parameter of the point of collision on the sweep, only applicable if hit.
+    /// </summary>
+    float t = 0.0f;
+
+    /// <summary>
+    /// Direction after the collision, only applicable if hit.
+    /// </summary>
+    glm::vec2 reflectedDirection = {};
+
+    /// <summary>
+    /// Index of the rectangle hit, only filled by the batched brick tests.
+    /// </summary>
+    uint32_t rect = UINT32_MAX;
+};
+
+/// <summary>
+/// Times the current collision tests against the edge by edge tests they replaced, on randomly generated sweeps.
+/// </summary>
+class PhysicsBenchmark {
+  public:
+    /// <summary>
+    /// Generates the sweeps. Half of them are aimed at the rectangle, the rest go in random directions.
+    /// </summary>
+    /// <param name="caseCount">Number of sweeps to generate.</param>
+    /// <param name="seed">Seed of the random generator.</param>
+    PhysicsBenchmark(const uint32_t& caseCount, const uint32_t& seed) : m_cases(caseCount) {
+        std::mt19937                          random(seed);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        for (uint32_t i = 0; i < caseCount; ++i) {
+            CollisionCase& collisionCase = m_cases[i];
+            collisionCase.rectCenter     = {WINDOW_WIDTH * 0.5f + 400.0f * unit(random), WINDOW_HEIGHT * 0.5f + 200.0f * unit(random)};
+            collisionCase.rectDimensions = {50.0f + 30.0f * unit(random), 20.0f + 10.0f * unit(random)};
+            collisionCase.start          = collisionCase.rectCenter + glm::vec2(100.0f * unit(random), 60.0f * unit(random));
+            collisionCase.distance       = CASE_MAX_DISTANCE * 0.5f * (unit(random) + 1.0f);
+
+            glm::vec2 direction = i % 2 ? collisionCase.rectCenter - collisionCase.start : glm::vec2(unit(random), unit(random));
+            if (direction == glm::vec2(0.0f)) {
+                direction = {0.0f, -1.0f};
+            }
+            collisionCase.direction = glm::normalize(direction + (i % 2 ? 10.0f * glm::vec2(unit(random), unit(random)) : glm::vec2(0.0f)));
+        }
+
+        // Batched brick tests sweep case i against the rectangles of the batch it falls in, one of them its own, with some of the lanes masked out
+        const uint32_t batchWidth = m_physics.getBatchWidth();
+        const uint32_t fullMask   = (1u << batchWidth) - 1;
+        m_batchRects.x.assign(caseCount + COLLIDER_PADDING, -WINDOW_WIDTH);
+        m_batchRects.y.assign(caseCount + COLLIDER_PADDING, -WINDOW_HEIGHT);
+        m_batchRects.halfWidth.assign(caseCount + COLLIDER_PADDING, 0.0f);
+        m_batchRects.halfHeight.assign(caseCount + COLLIDER_PADDING, 0.0f);
+        m_batchLaneMasks.resize(caseCount);
+        for (uint32_t i = 0; i < caseCount; ++i) {
+            m_batchRects.x[i]          = m_cases[i].rectCenter.x;
+            m_batchRects.y[i]          = m_cases[i].rectCenter.y;
+            m_batchRects.halfWidth[i]  = 0.5f * m_cases[i].rectDimensions.x;
+            m_batchRects.halfHeight[i] = 0.5f * m_cases[i].rectDimensions.y;
+            m_batchLaneMasks[i]        = i % 4 ? fullMask : static_cast<uint32_t>(random()) & fullMask;
+        }
+    }
+
+    /// <summary>
+    /// Runs all tests in both versions and prints their timings and how often their results agree.
+    /// </summary>
+    /// <param name="repeatCount">Number of times each test is run over all sweeps.</param>
+    void run(const uint32_t& repeatCount) {
+        printf("%-12s %12s %12s %8s %8s %10s\n", "test", "edges ns", "slab ns", "speedup", "hits", "agreement");
+
+        compare("walls", repeatCount, &PhysicsBenchmark::wallsEdges, &PhysicsBenchmark::wallsSlab);
+        compare("pad", repeatCount, &PhysicsBenchmark::padEdges, &PhysicsBenchmark::padSlab);
+        compare("brick", repeatCount, &PhysicsBenchmark::brickEdges, &PhysicsBenchmark::brickSlab);
+
+        printf("\n%-12s %12s %12s %8s %8s %10s %10s %10s\n", "test", "scalar ns", "batch ns", "speedup", "hits", "identical", "mismatches", "max diff");
+        compareBatch(repeatCount);
+    }
+
+  private:
+    typedef CollisionResult (PhysicsBenchmark::*CollisionTest)(const CollisionCase& collisionCase);
+
+    /// <summary>
+    /// Physics whose collision tests are timed.
+    /// </summary>
+    Physics m_physics;
+
+    /// <summary>
+    /// Generated sweeps.
+    /// </summary>
+    std::vector<CollisionCase> m_cases;
+
+    /// <summary>
+    /// Rectangles of the generated sweeps in the layout the batched brick test reads, padded for a full batch past the last one.
+    /// </summary>
+    BrickColliders m_batchRects;
+
+    /// <summary>
+    /// Rectangles of its batch each sweep is tested against in the batched brick tests, bit i standing for the i-th rectangle of the batch.
+    /// </summary>
+    std::vector<uint32_t> m_batchLaneMasks;
+
+    /// <summary>
+    /// Times both versions of a test and prints a line of the result table.
+    /// </summary>
+    /// <param name="name">Name of the test.</param>
+    /// <param name="repeatCount">Number of times each version is run over all sweeps.</param>
+    /// <param name="edgesTest">Version testing the edges one by one.</param>
+    /// <param name="slabTest">Version using the slab test.</param>
+    void compare(const char* name, const uint32_t& repeatCount, CollisionTest edgesTest, CollisionTest slabTest) {
+        uint32_t hits      = 0;
+        uint32_t agreement = 0;
+        for (const CollisionCase& collisionCase : m_cases) {
+            CollisionResult edges = (this->*edgesTest)(collisionCase);
+            CollisionResult slab  = (this->*slabTest)(collisionCase);
+
+            hits += edges.hit;
+            agreement += edges.hit == slab.hit && (!edges.hit || (std::abs(edges.t - slab.t) < AGREEMENT_TOLERANCE &&
+                                                                  glm::distance(edges.reflectedDirection, slab.reflectedDirection) < AGREEMENT_TOLERANCE));
+        }
+
+        double edgesTime = time(repeatCount, edgesTest);
+        double slabTime  = time(repeatCount, slabTest);
+        printf("%-12s %12.2f %12.2f %7.2fx %7.1f%% %9.3f%%\n", name, edgesTime, slabTime, edgesTime / slabTime, 100.0 * hits / m_cases.size(),
+               100.0 * agreement / m_cases.size());
+    }
+
+    /// <summary>
+    /// Times the batched brick test against testing the same rectangles one by one with the scalar test and prints a line of the result table. Results are
+    /// identical if both pick the same rectangle at the same collision parameter, and mismatch if they pick different rectangles or their collision
+    /// parameters differ by AGREEMENT_TOLERANCE or more.
+    /// </summary>
+    /// <param name="repeatCount">Number of times each version is run over all sweeps.</param>
+    void compareBatch(const uint32_t& repeatCount) {
+        uint32_t hits            = 0;
+        uint32_t identical       = 0;
+        uint32_t mismatches      = 0;
+        float    largestDistance = 0.0f;
+        for (const CollisionCase& collisionCase : m_cases) {
+            CollisionResult scalar = brickScalarBatch(collisionCase);
+            CollisionResult batch  = brickBatch(collisionCase);
+
+            const float distance = scalar.hit && batch.hit ? std::abs(scalar.t - batch.t) : 0.0f;
+            largestDistance      = std::max(largestDistance, distance);
+
+            hits += scalar.hit;
+            identical += scalar.rect == batch.rect && distance == 0.0f;
+            mismatches += scalar.rect != batch.rect || distance >= AGREEMENT_TOLERANCE;
+        }
+
+        double scalarTime = time(repeatCount, &PhysicsBenchmark::brickScalarBatch);
+        double batchTime  = time(repeatCount, &PhysicsBenchmark::brickBatch);
+        printf("%-12s %12.2f %12.2f %7.2fx %7.1f%% %9.3f%% %10u %10.2e\n", "brick batch", scalarTime, batchTime, scalarTime / batchTime,
+               100.0 * hits / m_cases.size(), 100.0 * identical / m_cases.size(), mismatches, largestDistance);
+    }
+
+    /// <summary>
+    /// Runs a test over all sweeps.
+    /// </summary>
+    /// <param name="repeatCount">Number of times the test is run over all sweeps.</param>
+    /// <param name="test">Test to be run.</param>
+    /// <returns>Average duration of a single test in nanoseconds.</returns>
+    double time(const uint32_t& repeatCount, CollisionTest test) {
+        // The results are summed so that the compiler can not drop the tests
+        float      checksum = 0.0f;
+        const auto start    = std::chrono::high_resolution_clock::now();
+        for (uint32_t repeat = 0; repeat < repeatCount; ++repeat) {
+            for (const CollisionCase& collisionCase : m_cases) {
+                CollisionResult result = (this->*test)(collisionCase);
+                checksum += result.hit ? result.t : 0.0f;
+            }
+        }
+        const double duration = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (checksum < 0.0f) {
+            printf("Negative checksum %f\n", checksum);
+        }
+        return duration / (static_cast<double>(repeatCount) * m_cases.size());
+    }
+
+    /// <summary>
+    /// Box of the walls the ball travels in.
+    /// </summary>
+    /// <param name="boxMin">Top left corner of the box.</param>
+    /// <param name="boxMax">Bottom right corner of the box.</param>
+    void wallBox(glm::vec2& boxMin, glm::vec2& boxMax) {
+        boxMin = {CASE_BALL_RADIUS, CASE_BALL_RADIUS};
+        boxMax = {WINDOW_WIDTH - CASE_BALL_RADIUS, WINDOW_HEIGHT + CASE_BALL_RADIUS};
+    }
+
+    /// <summary>
+    /// Wall test as it was done before the slab test, with a segment test per wall. Walls are swept over a longer path so that they get hit.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult wallsEdges(const CollisionCase& collisionCase) {
+        glm::vec2 boxMin, boxMax;
+        wallBox(boxMin, boxMax);
+
+        glm::vec2 topLeftCorner     = boxMin;
+        glm::vec2 topRightCorner    = {boxMax.x, boxMin.y};
+        glm::vec2 bottomLeftCorner  = {boxMin.x, boxMax.y};
+        glm::vec2 bottomRightCorner = boxMax;
+        glm::vec2 travelPath        = collisionCase.direction * collisionCase.distance * 10.0f;
+
+        CollisionResult result;
+        result.t = 2.0f;
+        float t;
+
+        // Bottom wall
+        if (m_physics.segmentSegmentCollisionStatic(collisionCase.start, travelPath, bottomLeftCorner, bottomRightCorner - bottomLeftCorner, t)) {
+            result.hit                = true;
+            result.t                  = t;
+            result.reflectedDirection = {collisionCase.direction.x, -collisionCase.direction.y};
+            return result;
+        }
+
+        // Top wall
+        if (m_physics.segmentSegmentCollisionStatic(collisionCase.start, travelPath, topLeftCorner, topRightCorner - topLeftCorner, t) && t < result.t) {
+            result.hit                = true;
+            result.t                  = t;
+            result.reflectedDirection = {collisionCase.direction.x, -collisionCase.direction.y};
+        }
+
+        // Left wall
+        if (m_physics.segmentSegmentCollisionStatic(collisionCase.start, travelPath, bottomLeftCorner, topLeftCorner - bottomLeftCorner, t) && t < result.t) {
+            result.hit                = true;
+            result.t                  = t;
+            result.reflectedDirection = {-collisionCase.direction.x, collisionCase.direction.y};
+        }
+
+        // Right wall
+        if (m_physics.segmentSegmentCollisionStatic(collisionCase.start, travelPath, bottomRightCorner, topRightCorner - bottomRightCorner, t) &&
+            t < result.t) {
+            result.hit                = true;
+            result.t                  = t;
+            result.reflectedDirection = {-collisionCase.direction.x, collisionCase.direction.y};
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Wall test with the slab test. Walls are swept over a longer path so that they get hit.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult wallsSlab(const CollisionCase& collisionCase) {
+        glm::vec2 boxMin, boxMax;
+        wallBox(boxMin, boxMax);
+
+        CollisionResult result;
+        bool            sideWall;
+        result.hit = m_physics.wallBoxCollision(collisionCase.start, collisionCase.direction * collisionCase.distance * 10.0f, boxMin, boxMax, result.t,
+                                                sideWall);
+        if (result.hit) {
+            result.reflectedDirection = sideWall ? glm::vec2(-collisionCase.direction.x, collisionCase.direction.y)
+                                                 : glm::vec2(collisionCase.direction.x, -collisionCase.direction.y);
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// Ball against the pad, testing the edges one by one.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult padEdges(const CollisionCase& collisionCase) {
+        CollisionResult result;
+        result.hit = m_physics.rectRectCollisionEdges(collisionCase.start, glm::vec2(2.0f * CASE_BALL_RADIUS), collisionCase.direction,
+                                                      collisionCase.distance, collisionCase.rectCenter, collisionCase.rectDimensions, result.t,
+                                                      result.reflectedDirection);
+        return result;
+    }
+
+    /// <summary>
+    /// Ball against the pad with the slab test.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult padSlab(const CollisionCase& collisionCase) {
+        CollisionResult result;
+        result.hit = m_physics.rectRectCollisionDynamic(collisionCase.start, glm::vec2(2.0f * CASE_BALL_RADIUS), collisionCase.direction,
+                                                        collisionCase.distance, collisionCase.rectCenter, collisionCase.rectDimensions, result.t,
+                                                        result.reflectedDirection);
+        return result;
+    }
+
+    /// <summary>
+    /// Ball against a brick, testing the edges and the corners one by one.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult brickEdges(const CollisionCase& collisionCase) {
+        CollisionResult result;
+        result.hit = m_physics.circleRectCollisionEdges(collisionCase.start, CASE_BALL_RADIUS, collisionCase.direction, collisionCase.distance,
+                                                        collisionCase.rectCenter, collisionCase.rectDimensions, result.t, result.reflectedDirection);
+        return result;
+    }
+
+    /// <summary>
+    /// Ball against a brick with the slab test.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult brickSlab(const CollisionCase& collisionCase) {
+        CollisionResult result;
+        result.hit = m_physics.circleRectCollisionDynamic(collisionCase.start, CASE_BALL_RADIUS, collisionCase.direction, collisionCase.distance,
+                                                          collisionCase.rectCenter, collisionCase.rectDimensions, result.t, result.reflectedDirection);
+        return result;
+    }
+
+    /// <summary>
+    /// Ball against the rectangles of its batch, testing them one by one with the scalar slab test and keeping the first of the closest hits.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested, one of m_cases.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult brickScalarBatch(const CollisionCase& collisionCase) {
+        const uint32_t caseIndex = static_cast<uint32_t>(&collisionCase - m_cases.data());
+        const uint32_t firstRect = caseIndex - caseIndex % m_physics.getBatchWidth();
+
+        CollisionResult result;
+        result.t = 2.0f;
+        for (uint32_t lane = 0; lane < m_physics.getBatchWidth(); ++lane) {
+            const uint32_t i = firstRect + lane;
+            float          t;
+            glm::vec2      reflectedDirection;
+            if (((m_batchLaneMasks[caseIndex] >> lane) & 1u) &&
+                m_physics.circleRectCollisionDynamic(collisionCase.start, CASE_BALL_RADIUS, collisionCase.direction, collisionCase.distance,
+                                                     {m_batchRects.x[i], m_batchRects.y[i]},
+                                                     {2.0f * m_batchRects.halfWidth[i], 2.0f * m_batchRects.halfHeight[i]}, t, reflectedDirection) &&
+                t < result.t) {
+                result.hit  = true;
+                result.t    = t;
+                result.rect = i;
+            }
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// Ball against the rectangles of its batch with the batched slab test.
+    /// </summary>
+    /// <param name="collisionCase">Sweep to be tested, one of m_cases.</param>
+    /// <returns>Outcome of the test.</returns>
+    CollisionResult brickBatch(const CollisionCase& collisionCase) {
+        const uint32_t caseIndex = static_cast<uint32_t>(&collisionCase - m_cases.data());
+        const uint32_t firstRect = caseIndex - caseIndex % m_physics.getBatchWidth();
+
+        CollisionResult result;
+        result.rect = m_physics.circleRectCollisionBatch(collisionCase.start, CASE_BALL_RADIUS, collisionCase.direction, collisionCase.distance, m_batchRects,
+                                                         firstRect, m_batchLaneMasks[caseIndex], result.t);
+        result.hit  = result.rect != UINT32_MAX;
+        return result;
+    }
+};
+
+/// <summary>
+/// Counts the cache misses of the calling thread with the hardware performance counters. Only available on Linux, and only where perf_event_open is
+/// permitted and the counter is exposed, on other systems the counter reports itself unavailable.
+/// </summary>
+class CacheMissCounter {
+  public:
+    /// <summary>
+    /// Opens the counter, disabled.
+    /// </summary>
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attributes = {};
+        attributes.type            = PERF_TYPE_HARDWARE;
+        attributes.size            = sizeof(attributes);
+        attributes.config          = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.disabled        = 1;
+        attributes.exclude_kernel  = 1;
+        attributes.exclude_hv      = 1;
+        m_descriptor               = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (m_descriptor >= 0) {
+            close(m_descriptor);
+        }
+#endif
+    }
+
+    /// <summary>
+    /// Checks if the counter could be opened.
+    /// </summary>
+    /// <returns>True if the counter can be read.</returns>
+    bool isAvailable() const { return m_descriptor >= 0; }
+
+    /// <summary>
+    /// Zeroes the counter and starts counting.
+    /// </summary>
+    void start() {
+#ifdef __linux__
+        if (m_descriptor >= 0) {
+            ioctl(m_descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// <summary>
+    /// Stops counting.
+    /// </summary>
+    /// <returns>Cache misses counted since the counter was started, 0 if the counter is not available.</returns>
+    uint64_t stop() {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (m_descriptor >= 0) {
+            ioctl(m_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_descriptor, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+  private:
+    /// <summary>
+    /// File descriptor of the counter, negative if it could not be opened.
+    /// </summary>
+    int m_descriptor = -1;
+};
+
+/// <summary>
+/// Shape of a generated board.
+/// </summary>
+struct BoardShape {
+    /// <summary>
+    /// Number of brick rows.
+    /// </summary>
+    uint32_t rowCount;
+
+    /// <summary>
+    /// Number of brick columns.
+    /// </summary>
+    uint32_t columnCount;
+
+    /// <summary>
+    /// Fraction of the cells holding a brick.
+    /// </summary>
+    float density;
+
+    /// <summary>
+    /// Only every rowStride-th row holds bricks, the rest are left empty.
+    /// </summary>
+    uint32_t rowStride = 1;
+
+    /// <summary>
+    /// Velocity of the rows holding bricks in play area widths per second, alternating in sign from row to row. Zero for static boards.
+    /// </summary>
+    float rowVelocity = 0.0f;
+};
+
+/// <summary>
+/// Result of timing the physics steps on a single board.
+/// </summary>
+struct BoardTiming {
+    /// <summary>
+    /// Time the timed steps took in nanoseconds.
+    /// </summary>
+    double duration = 0.0;
+
+    /// <summary>
+    /// Number of bounces resolved during the timed steps.
+    /// </summary>
+    uint64_t bounces = 0;
+
+    /// <summary>
+    /// Number of times all balls were lost and launched again.
+    /// </summary>
+    uint32_t lostCount = 0;
+
+    /// <summary>
+    /// Number of cache misses during the timed steps, 0 if the counter is not available.
+    /// </summary>
+    uint64_t misses = 0;
+
+    /// <summary>
+    /// Sub-step counters of the timed steps.
+    /// </summary>
+    SubStepStatistics subSteps;
+};
+
+/// <summary>
+/// Times whole physics steps on generated boards of indestructible bricks, so the board stays the same for the whole measurement. The pad follows the
+/// lowest ball and lost balls are put back into play, nothing is rendered.
+/// </summary>
+class BoardBenchmark {
+  public:
+    /// <summary>
+    /// Sets up the benchmark.
+    /// </summary>
+    /// <param name="stepCount">Number of timed physics steps per board and ball speed.</param>
+    /// <param name="ballCount">Number of balls in play.</param>
+    /// <param name="seed">Seed of the generated boards and the ball directions.</param>
+    BoardBenchmark(const uint32_t& stepCount, const uint32_t& ballCount, const uint32_t& seed) : m_stepCount(stepCount), m_ballCount(ballCount), m_seed(seed) {}
+
+    /// <summary>
+    /// Runs every board at every ball speed and prints the timings.
+    /// </summary>
+    void run() {
+        // Moving rows are kept two empty rows apart, the same board with static rows is the baseline for them
+        const BoardShape shapes[] = {{10, 10, 0.25f},
+                                     {10, 10, 1.0f},
+                                     {20, 20, 0.25f},
+                                     {20, 20, 0.5f},
+                                     {20, 20, 1.0f},
+                                     {MAX_ROW_COUNT, MAX_COLUMN_COUNT, 0.25f},
+                                     {MAX_ROW_COUNT, MAX_COLUMN_COUNT, 0.5f},
+                                     {MAX_ROW_COUNT, MAX_COLUMN_COUNT, 1.0f},
+                                     {MAX_ROW_COUNT, MAX_COLUMN_COUNT, 0.5f, 3},
+                                     {MAX_ROW_COUNT, MAX_COLUMN_COUNT, 0.5f, 3, BENCH_ROW_VELOCITY}};
+        const float      speeds[] = {1.0f, 2.0f, 4.0f};
+
+        printf("%-24s %8s %6s %10s %10s %11s %12s %12s %8s %10s %8s\n", "board", "bricks", "speed", "ns/step", "linear ns", "grid/linear", "bounces/s",
+               "misses/step", "lost", "sub-steps", "capped");
+
+        for (const BoardShape& shape : shapes) {
+            const std::filesystem::path boardPath  = std::filesystem::temp_directory_path() / "breakout_bench_board.xml";
+            const uint32_t              brickCount = writeBoard(boardPath, shape, m_ballCount);
+
+            Level level(boardPath.string().c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, nullptr, nullptr, nullptr);
+            std::filesystem::remove(boardPath);
+
+            for (const float& speed : speeds) {
+                // Linear scan reference tests every brick on the grid, the balls take the same paths so only the time differs
+                m_physics.m_linearScan         = true;
+                const BoardTiming linearTiming = measure(level, m_stepCount, speed, false);
+                m_physics.m_linearScan         = false;
+                const BoardTiming timing       = measure(level, m_stepCount, speed, false);
+
+                char missesPerStep[32] = "n/a";
+                if (m_cacheMisses.isAvailable()) {
+                    snprintf(missesPerStep, sizeof(missesPerStep), "%.2f", static_cast<double>(timing.misses) / m_stepCount);
+                }
+
+                // Sub-steps are averaged over the balls in play, balls capped by the sub-step budget are counted once per step
+                printf("%-24s %8u %5.0fx %10.1f %10.1f %11.3f %12.0f %12s %8u %10.3f %8llu\n", getBoardName(shape).c_str(), brickCount, speed,
+                       timing.duration / m_stepCount, linearTiming.duration / m_stepCount, timing.duration / linearTiming.duration,
+                       timing.bounces / (timing.duration * 0.000'000'001), missesPerStep, timing.lostCount,
+                       static_cast<double>(timing.subSteps.subStepCount) / std::max<uint64_t>(timing.subSteps.ballFrameCount, 1),
+                       static_cast<unsigned long long>(timing.subSteps.budgetReachedCount));
+            }
+        }
+    }
+
+    /// <summary>
+    /// Runs every board with more and more balls and prints the time per ball, which stays flat as long as the balls share the broadphase well.
+    /// </summary>
+    void runBallSweep() {
+        const BoardShape shapes[]     = {{10, 10, 0.5f}, {20, 20, 0.5f}, {MAX_ROW_COUNT, MAX_COLUMN_COUNT, 0.5f}};
+        const uint32_t   ballCounts[] = {1, 4, 16, 64, 256, MAX_BALL_COUNT};
+
+        printf("%-24s %8s %6s %10s %14s %10s\n", "board", "bricks", "balls", "ns/step", "ns/ball/step", "sub-steps");
+
+        for (const BoardShape& shape : shapes) {
+            for (const uint32_t& ballCount : ballCounts) {
+                const std::filesystem::path boardPath  = std::filesystem::temp_directory_path() / "breakout_bench_board.xml";
+                const uint32_t              brickCount = writeBoard(boardPath, shape, ballCount);
+
+                Level level(boardPath.string().c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, nullptr, nullptr, nullptr);
+                std::filesystem::remove(boardPath);
+
+                // Every row times about the same number of ball steps, with at least half of the balls in play, balls out of play are not counted
+                const uint32_t    stepCount = std::max(m_stepCount / ballCount, 1u);
+                const BoardTiming timing    = measure(level, stepCount, 1.0f, true);
+                const uint64_t    ballSteps = std::max<uint64_t>(timing.subSteps.ballFrameCount, 1);
+                printf("%-24s %8u %6u %10.1f %14.1f %10.3f\n", getBoardName(shape).c_str(), brickCount, ballCount, timing.duration / stepCount,
+                       timing.duration / ballSteps, static_cast<double>(timing.subSteps.subStepCount) / ballSteps);
+            }
+        }
+    }
+
+  private:
+    /// <summary>
+    /// Number of timed physics steps per board and ball speed.
+    /// </summary>
+    uint32_t m_stepCount;
+
+    /// <summary>
+    /// Number of balls in play.
+    /// </summary>
+    uint32_t m_ballCount;
+
+    /// <summary>
+    /// Seed of the generated boards and the ball directions.
+    /// </summary>
+    uint32_t m_seed;
+
+    /// <summary>
+    /// Physics whose steps are timed.
+    /// </summary>
+    Physics m_physics;
+
+    /// <summary>
+    /// Counter of the cache misses during the timed steps.
+    /// </summary>
+    CacheMissCounter m_cacheMisses;
+
+    /// <summary>
+    /// Names a board in the result tables.
+    /// </summary>
+    /// <param name="shape">Shape of the board.</param>
+    /// <returns>Dimensions and density of the board, followed by whether it is sparse and moving.</returns>
+    std::string getBoardName(const BoardShape& shape) {
+        char boardName[32];
+        snprintf(boardName, sizeof(boardName), "%ux%u %.0f%%%s%s", shape.rowCount, shape.columnCount, 100.0f * shape.density,
+                 shape.rowStride > 1 ? " sparse" : "", shape.rowVelocity != 0.0f ? " moving" : "");
+        return boardName;
+    }
+
+    /// <summary>
+    /// Writes a level file with the bricks scattered at random over the grid.
+    /// </summary>
+    /// <param name="boardPath">Path of the level file.</param>
+    /// <param name="shape">Shape of the board.</param>
+    /// <param name="ballCount">Number of balls in play.</param>
+    /// <returns>Number of bricks placed.</returns>
+    uint32_t writeBoard(const std::filesystem::path& boardPath, const BoardShape& shape, const uint32_t& ballCount) {
+        std::ofstream board(boardPath);
+        if (!board) {
+            char error[512];
+            snprintf(error, sizeof(error), "Failed to create file at location %s!", boardPath.string().c_str());
+            throw std::runtime_error(error);
+        }
+
+        board << "<Level RowCount=\"" << shape.rowCount << "\" ColumnCount=\"" << shape.columnCount << "\" RowSpacing=\"3\" ColumnSpacing=\"3\" "
+              << "BackgroundTexture=\"\" BallCount=\"" << ballCount << "\">\n"
+              << "  <BrickTypes>\n"
+              << "    <BrickType Id=\"H\" Texture=\"\" HitPoints=\"Infinite\" />\n"
+              << "  </BrickTypes>\n"
+              << "  <Bricks>\n";
+
+        std::mt19937                          random(m_seed);
+        std::uniform_real_distribution<float> cell(0.0f, 1.0f);
+
+        uint32_t brickCount = 0;
+        for (uint32_t row = 0; row < shape.rowCount; ++row) {
+            const bool  filled   = row % shape.rowStride == 0;
+            const float velocity = (row / shape.rowStride) % 2 ? -shape.rowVelocity : shape.rowVelocity;
+            board << "    <Row Velocity=\"" << (filled ? velocity : 0.0f) << "\">";
+            for (uint32_t column = 0; column < shape.columnCount; ++column) {
+                const bool brick = cell(random) < shape.density && filled;
+                board << (column ? " " : "") << (brick ? "H" : "_");
+                brickCount += brick;
+            }
+            board << "</Row>\n";
+        }
+
+        board << "  </Bricks>\n"
+              << "</Level>\n";
+        return brickCount;
+    }
+
+    /// <summary>
+    /// Puts the pad and the balls back to their starting positions and launches the balls upwards in random directions.
+    /// </summary>
+    /// <param name="level">Level being played.</param>
+    /// <param name="random">Random generator of the directions.</param>
+    /// <param name="ballDirections">Directions of the balls. Method updates these values.</param>
+    void launchBalls(Level& level, std::mt19937& random, std::vector<glm::vec2>& ballDirections) {
+        std::uniform_real_distribution<float> sideways(-MAX_LAUNCH_SLOPE, MAX_LAUNCH_SLOPE);
+
+        level.resetPadAndBall();
+        for (glm::vec2& ballDirection : ballDirections) {
+            ballDirection = glm::normalize(glm::vec2(sideways(random), -1.0f));
+        }
+    }
+
+    /// <summary>
+    /// Runs a single physics step, steering the pad under the lowest ball.
+    /// </summary>
+    /// <param name="level">Level being played.</param>
+    /// <param name="tickTime">Duration of the simulation step.</param>
+    /// <param name="ballSpeed">Speed of the balls, relative to the base speed of the level.</param>
+    /// <param name="aimOffset">Distance from the pad center the pad aims to hit the ball at.</param>
+    /// <param name="ballDirections">Directions of the balls. Method updates these values.</param>
+    /// <param name="collisionEvents">Collisions of the step. Method fills these values.</param>
+    /// <returns>State of the level after the step.</returns>
+    LevelState step(Level& level, const uint32_t& tickTime, const float& ballSpeed, const float& aimOffset, std::vector<glm::vec2>& ballDirections,
+                    CollisionEventRing& collisionEvents) {
+        const std::vector<Instance>& instances = level.getInstances();
+
+        float lowestBallX = instances[PAD_INDEX].position.x;
+        float lowestBallY = -1.0f;
+        for (uint32_t i = 0; i < level.getBallCount(); ++i) {
+            const glm::vec2& ballPosition = instances[level.getBallIndex() + i].position;
+            if (level.isBallActive(i) && ballPosition.y > lowestBallY) {
+                lowestBallX = ballPosition.x;
+                lowestBallY = ballPosition.y;
+            }
+        }
+
+        const float padStep    = level.getBasePadSpeed() * tickTime;
+        const float padControl = std::clamp((lowestBallX + aimOffset - instances[PAD_INDEX].position.x) / padStep, -1.0f, 1.0f);
+
+        return m_physics.resolveFrame(tickTime, level, ballSpeed, padControl, ballDirections, collisionEvents);
+    }
+
+    /// <summary>
+    /// Times the physics steps on a single board at a single ball speed.
+    /// </summary>
+    /// <param name="level">Level made from the board.</param>
+    /// <param name="timedStepCount">Number of timed physics steps.</param>
+    /// <param name="ballSpeed">Speed of the balls, relative to the base speed of the level.</param>
+    /// <param name="keepBallsInPlay">True to launch the balls again once half of them are lost, not only once all of them are.</param>
+    /// <returns>Timing of the steps.</returns>
+    BoardTiming measure(Level& level, const uint32_t& timedStepCount, const float& ballSpeed, const bool& keepBallsInPlay) {
+        const uint32_t tickTime = 1'000'000 / PHYSICS_TICK_RATE;
+
+        std::mt19937                          random(m_seed);
+        std::uniform_real_distribution<float> aimDistribution(-MAX_AIM_OFFSET, MAX_AIM_OFFSET);
+
+        std::vector<glm::vec2> ballDirections(level.getBallCount());
+        CollisionEventRing     collisionEvents;
+
+        level.load(START_LIFE_COUNT, 0, 1);
+        launchBalls(level, random, ballDirections);
+
+        const float padWidth  = level.getInstances()[PAD_INDEX].scale.x;
+        float       aimOffset = aimDistribution(random) * padWidth;
+
+        uint64_t bounces   = 0;
+        uint32_t lostCount = 0;
+
+        auto play = [&](const uint32_t& stepCount) {
+            for (uint32_t i = 0; i < stepCount; ++i) {
+                const LevelState state = step(level, tickTime, ballSpeed, aimOffset, ballDirections, collisionEvents);
+                lostCount += state == LevelState::LOST;
+                if (state == LevelState::LOST || (keepBallsInPlay && 2 * level.getActiveBallCount() < level.getBallCount())) {
+                    launchBalls(level, random, ballDirections);
+                }
+
+                CollisionData collisionData;
+                while (collisionEvents.pop(collisionData)) {
+                    if (collisionData.type == CollisionType::PAD) {
+                        aimOffset = aimDistribution(random) * padWidth;
+                    }
+                    bounces += collisionData.type != CollisionType::BALL_LOST;
+                }
+            }
+        };
+
+        play(WARMUP_STEP_COUNT);
+        bounces   = 0;
+        lostCount = 0;
+        m_physics.resetSubStepStatistics();
+
+        // Steering the pad and putting lost balls back into play are timed along with the steps, both are negligible next to a step
+        m_cacheMisses.start();
+        const auto start = std::chrono::high_resolution_clock::now();
+        play(timedStepCount);
+        const double duration = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        BoardTiming timing;
+        timing.misses    = m_cacheMisses.stop();
+        timing.duration  = duration;
+        timing.bounces   = bounces;
+        timing.lostCount = lostCount;
+        timing.subSteps  = m_physics.getSubStepStatistics();
+        return timing;
+    }
+};
+
+/// <summary>
+/// Prints the command line options.
+/// </summary>
+static void printUsage() {
+    printf("Usage: breakout_bench [options]\n"
+           "  --suite <name>       Benchmarks to run, tests, boards, balls or all (default all)\n"
+           "  --cases <count>      Randomly generated sweeps per test (default %d)\n"
+           "  --repeat <count>     Times each test is run over all sweeps (default %d)\n"
+           "  --steps <count>      Timed physics steps per board and ball speed (default %d)\n"
+           "  --balls <count>      Balls in play on the boards, at most %d (default %d)\n"
+           "  --seed <value>       Seed of the generated sweeps and boards (default 0)\n",
+           DEFAULT_CASE_COUNT, DEFAULT_REPEAT_COUNT, DEFAULT_STEP_COUNT, MAX_BALL_COUNT, DEFAULT_BALL_COUNT);
+}
+
+int main(int argc, char* argv[]) {
+    std::string suite       = "all";
+    uint32_t    caseCount   = DEFAULT_CASE_COUNT;
+    uint32_t    repeatCount = DEFAULT_REPEAT_COUNT;
+    uint32_t    stepCount   = DEFAULT_STEP_COUNT;
+    uint32_t    ballCount   = DEFAULT_BALL_COUNT;
+    uint32_t    seed        = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && !strcmp(argv[i], "--suite")) {
+            suite = argv[++i];
+        } else if (i + 1 < argc && !strcmp(argv[i], "--cases")) {
+            caseCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--repeat")) {
+            repeatCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--steps")) {
+            stepCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--balls")) {
+            ballCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--seed")) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else {
+            printUsage();
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    if (suite != "tests" && suite != "boards" && suite != "balls" && suite != "all") {
+        printUsage();
+        return -1;
+    }
+
+    try {
+        if (suite == "tests" || suite == "all") {
+            printf("Timing collision tests on %u sweeps, %u times each\n\n", caseCount, repeatCount);
+
+            PhysicsBenchmark benchmark(std::max(caseCount, 1u), seed);
+            benchmark.run(std::max(repeatCount, 1u));
+        }
+
+        if (suite == "all") {
+            printf("\n");
+        }
+
+        if (suite == "boards" || suite == "all") {
+            printf("Timing %u physics steps per board with %u balls\n\n", stepCount, ballCount);
+
+            BoardBenchmark benchmark(std::max(stepCount, 1u), std::max(ballCount, 1u), seed);
+            benchmark.run();
+        }
+
+        if (suite == "all") {
+            printf("\n");
+        }
+
+        if (suite == "balls" || suite == "all") {
+            printf("Timing %u ball steps per board and ball count\n\n", stepCount);
+
+            BoardBenchmark benchmark(std::max(stepCount, 1u), std::max(ballCount, 1u), seed);
+            benchmark.runBallSweep();
+        }
+    } catch (std::runtime_error e) {
+        fprintf(stderr, "%s\n", e.what());
+        return -1;
+    }
+
+    return 0;
+}
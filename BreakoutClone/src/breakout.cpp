@@ -2,6 +2,7 @@
 #include "breakout.h"
 
 #include "physics.h"
+#include "profiler.h"
 #include "renderer.h"
 #include "sharedStructures.h"
 #include "soundManager.h"
@@ -9,10 +10,13 @@
 
 #include "common.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <random>
 #include <thread>
 
-Breakout::Breakout() {
+Breakout::Breakout(const PhysicsMode& physicsMode, const char* inputLogPath, const char* stateHashLogPath, const char* telemetryPath, const char* tracePath,
+                   const bool& autoplay, const uint32_t& targetFramerate, const PacingMode& pacingMode) {
     m_renderer       = std::make_unique<Renderer>();
     m_textureManager = std::make_unique<TextureManager>(m_renderer.get());
 
@@ -20,9 +24,36 @@ Breakout::Breakout() {
     m_renderer->uploadToDeviceLocalBuffer(&uniformData, sizeof(uniformData), m_renderer->getUniformBuffer()->buffer);
 
     m_soundManager = std::make_unique<SoundManager>();
-    m_physics      = std::make_unique<Physics>();
 
     loadAllLevels();
+    m_game = std::make_unique<Game>(m_levels, physicsMode);
+
+    if (inputLogPath) {
+        m_inputLog     = std::make_unique<InputLog>(m_tickTime, physicsMode, static_cast<uint32_t>(m_levels.size()));
+        m_inputLogPath = inputLogPath;
+    }
+
+    if (stateHashLogPath) {
+        m_stateHashLog     = std::make_unique<StateHashLog>();
+        m_stateHashLogPath = stateHashLogPath;
+    }
+
+    m_telemetry = std::make_unique<Telemetry>();
+    if (telemetryPath) {
+        m_telemetryPath = telemetryPath;
+    }
+
+    if (tracePath) {
+        m_tracePath = tracePath;
+        Profiler::start();
+    }
+
+    if (autoplay) {
+        m_autoplayer = std::make_unique<Autoplayer>(std::random_device()());
+    }
+
+    m_framePacer   = std::make_unique<FramePacer>(targetFramerate == 0 ? 0 : 1'000'000 / targetFramerate, pacingMode);
+    m_framePackets = std::make_unique<FramePacketBuffer>();
 }
 
 Breakout::~Breakout() {}
@@ -30,208 +61,202 @@ Breakout::~Breakout() {}
 void Breakout::run() {
     m_renderer->showWindow();
     gameLoop();
+
+    if (m_inputLog) {
+        m_inputLog->save(m_inputLogPath.c_str());
+    }
+
+    if (m_stateHashLog) {
+        m_stateHashLog->save(m_stateHashLogPath.c_str());
+    }
+
+    if (!m_telemetryPath.empty()) {
+        m_telemetry->save(m_telemetryPath.c_str());
+    }
+
+    if (!m_tracePath.empty()) {
+        Profiler::save(m_tracePath.c_str());
+    }
 }
 
 void Breakout::loadAllLevels() {
     std::string path = std::filesystem::current_path().string() + LEVEL_FOLDER;
 
+    // Directory order depends on the file system, recorded input is only replayed on the same levels if they are sorted
+    std::vector<std::string> levelPaths;
     for (const auto& file : std::filesystem::directory_iterator(path)) {
-        m_levels.push_back(std::make_unique<Level>(file.path().string().c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, m_renderer.get(), m_textureManager.get()));
+        levelPaths.push_back(file.path().string());
+    }
+    std::sort(levelPaths.begin(), levelPaths.end());
+
+    for (const std::string& levelPath : levelPaths) {
+        m_levels.push_back(
+            std::make_unique<Level>(levelPath.c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, m_renderer.get(), m_textureManager.get(), m_soundManager.get()));
     }
 }
 
 void Breakout::gameLoop() {
     m_time = std::chrono::high_resolution_clock::now();
-    initializeLevel(START_LIFE_COUNT, 0, 0);
+    m_game->initializeLevel(START_LIFE_COUNT, 0, 0);
+
+    Profiler::setThreadName("simulation");
+    std::thread renderThread(&Breakout::renderLoop, this);
+    try {
+        simulationLoop();
+    } catch (...) {
+        m_quit = true;
+        renderThread.join();
+        throw;
+    }
+    renderThread.join();
 
-    while (!m_quit) {
-        pollEvents();
+    if (m_renderException) {
+        std::rethrow_exception(m_renderException);
+    }
+}
 
-        uint32_t frameTime            = getFrametime();
-        uint32_t m_operatingFrametime = m_targetFrameTime == 0 ? frameTime : m_targetFrameTime;
+void Breakout::simulationLoop() {
+    std::chrono::high_resolution_clock::time_point previousFrameStart;
+    while (!m_quit) {
+        PROFILE_ZONE("Breakout::simulationLoop");
 
-        doGame(m_operatingFrametime);
+        m_framePacer->beginFrame();
+        std::chrono::high_resolution_clock::time_point frameStart = std::chrono::high_resolution_clock::now();
+        if (m_framePacer->getFrameCount() > 0) {
+            m_telemetry->record(TelemetryStage::SIMULATION_FRAME, previousFrameStart, frameStart);
+        }
+        previousFrameStart = frameStart;
 
-        m_renderer->acquireImage();
-        m_renderer->renderAndPresentImage();
+        pollEvents();
+        std::chrono::high_resolution_clock::time_point inputEnd = std::chrono::high_resolution_clock::now();
+        m_telemetry->record(TelemetryStage::INPUT, frameStart, inputEnd);
 
-        m_stateTimeCounter += m_operatingFrametime;
-        m_timeCounter += m_operatingFrametime;
-        ++m_frameCount;
+        uint32_t frameTime = getFrametime();
 
-        if (m_operatingFrametime > frameTime) {
-            std::this_thread::sleep_for(std::chrono::microseconds(m_operatingFrametime - frameTime));
-        }
-        m_collisionInfo.clear();
-    }
-}
-
-void Breakout::doGame(const uint32_t& frameTime) {
-    switch (m_gameState) {
-        case GameState::BEGIN_LEVEL: {
-            if (m_stateTimeCounter < BEGIN_LEVEL_BEFORE_FADE + BEGIN_LEVEL_FADE) {
-                float alpha = fade(BEGIN_LEVEL_BEFORE_FADE, -BEGIN_LEVEL_FADE, m_stateTimeCounter);
-                m_currentLevel->setForegroundVisibility(alpha);
-                m_currentLevel->setTitleVisibility(alpha);
-            } else {
-                m_currentLevel->setSubtitle(TEXTURE_UI_RELEASE);
-                m_currentLevel->setSubtitleVisibility(1.0f);
-                m_gameState = GameState::BALL_ATTACHED;
+        // Simulation runs in fixed steps, leftover time is carried over to the next frame
+        m_accumulatedTime = std::min(m_accumulatedTime + frameTime, MAX_TICKS_PER_FRAME * m_tickTime);
+        while (m_accumulatedTime >= m_tickTime && !m_quit) {
+            m_game->getCurrentLevel()->storePreviousPositions();
+            if (m_autoplayer) {
+                m_autoplayer->play(*m_game, m_tickTime, m_input);
             }
-            break;
-        }
-        case GameState::BALL_ATTACHED: {
-            m_physics->resolveFrame(frameTime, *m_currentLevel, 0.0f, m_padControl, m_ballDirection, m_collisionInfo);
-            if (m_keyPressed[SDLK_SPACE]) {
-                m_ballDirection = m_currentLevel->getStartingBallDirection();
-                m_currentLevel->setSubtitleVisibility(0.0f);
-                m_gameState = GameState::PLAYING;
+            if (m_inputLog) {
+                m_inputLog->record(m_input);
             }
-            break;
-        }
-        case GameState::PLAYING: {
-            switch (m_physics->resolveFrame(frameTime, *m_currentLevel, 1.0f, m_padControl, m_ballDirection, m_collisionInfo)) {
-                case LevelState::STILL_ALIVE: {
-                    Instance* const bricks = m_currentLevel->getBricksPtr();
-                    for (CollisionData& collisionData : m_collisionInfo) {
-                        switch (collisionData.type) {
-                            case CollisionType::WALL: {
-                                m_soundManager->playSound(SOUND_WALL);
-                                break;
-                            }
-                            case CollisionType::PAD: {
-                                m_soundManager->playSound(SOUND_PAD);
-                                break;
-                            }
-                            case CollisionType::BRICK: {
-                                Instance&        brick     = bricks[collisionData.hitBrickIndex];
-                                const BrickType& brickType = m_currentLevel->getBrickData(brick.id);
-                                if (brick.maxHealth < UINT32_MAX) {
-                                    --brick.health;
-                                    if (brick.health <= 0) {
-                                        m_score += brickType.breakScore;
-                                        m_currentLevel->setScore(m_score);
-                                        m_currentLevel->destroyBrick();
-                                        m_soundManager->playSound(brickType.breakSoundPath);
-                                    } else {
-                                        m_soundManager->playSound(brickType.hitSoundPath);
-                                    }
-                                } else {
-                                    m_soundManager->playSound(brickType.hitSoundPath);
-                                }
-                                break;
-                            }
-                        }
-                    }
-
-                    if (m_currentLevel->getRemainingBrickCount() == 0) {
-                        if (m_currentLevelIndex == m_levels.size() - 1) {
-                            m_currentLevel->setTitle(TEXTURE_UI_VICTORY);
-                        } else {
-                            m_currentLevel->setTitle(TEXTURE_UI_LEVEL_COMPLETE);
-                        }
-
-                        m_gameState        = GameState::WIN_LEVEL;
-                        m_stateTimeCounter = 0;
-                    }
-                    break;
-                }
-                case LevelState::LOST: {
-                    m_soundManager->playSound(SOUND_WILHELM);
-                    --m_lifeCount;
-                    m_currentLevel->setLifeCount(m_lifeCount);
-                    if (m_lifeCount == 0) {
-                        m_stateTimeCounter = 0;
-                        m_currentLevel->setTitle(TEXTURE_UI_GAME_OVER);
-                        m_gameState = GameState::LOSE_GAME;
-                    } else {
-                        m_currentLevel->resetPadAndBall();
-                        m_currentLevel->setSubtitle(TEXTURE_UI_RELEASE);
-                        m_currentLevel->setSubtitleVisibility(1.0f);
-                        m_gameState = GameState::BALL_ATTACHED;
-                    }
-                    break;
-                }
+            m_game->tick(m_tickTime, m_input);
+            if (m_stateHashLog) {
+                m_stateHashLog->record(m_game->getStateHash());
             }
-            break;
-        }
-        case GameState::LOSE_GAME: {
-            if (m_stateTimeCounter < LOSE_GAME_FADE) {
-                float alpha = fade(0, LOSE_GAME_FADE, m_stateTimeCounter);
-                m_currentLevel->setForegroundVisibility(alpha);
-                m_currentLevel->setTitleVisibility(alpha);
-            } else {
-                m_currentLevel->setSubtitle(TEXTURE_UI_TRY);
-                m_currentLevel->setSubtitleVisibility(1.0f);
-                m_gameState = GameState::RESTART_SCREEN;
+            for (const uint32_t& sound : m_game->getSounds()) {
+                m_soundManager->playSound(sound);
             }
-            break;
-        }
-        case GameState::RESTART_SCREEN: {
-            if (m_keyPressed[SDLK_SPACE]) {
-                initializeLevel(START_LIFE_COUNT, 0, 0);
-                m_stateTimeCounter = 0;
-                m_currentLevel->setSubtitleVisibility(0.0f);
-                m_currentLevel->resetPadAndBall();
-            } else if (m_keyPressed[SDLK_ESCAPE]) {
+            if (m_game->isQuitRequested()) {
                 m_quit = true;
             }
-            break;
+            m_accumulatedTime -= m_tickTime;
         }
 
-        case GameState::WIN_LEVEL: {
-            if (m_stateTimeCounter < LEVEL_WIN_FADE) {
-                float alpha = fade(0, LEVEL_WIN_FADE, m_stateTimeCounter);
-                m_currentLevel->setForegroundVisibility(alpha);
-                m_currentLevel->setTitleVisibility(alpha);
-            } else {
-                if (m_currentLevelIndex < m_levels.size() - 1) {
-                    initializeLevel(m_lifeCount, m_score, m_currentLevelIndex + 1);
-                } else {
-                    m_currentLevel->setSubtitle(TEXTURE_UI_TRY);
-                    m_currentLevel->setSubtitleVisibility(1.0f);
-                    m_gameState = GameState::WIN_GAME;
-                }
-            }
-            break;
+        // Pad and ball are drawn between their last two simulated positions
+        FramePacket& packet  = m_framePackets->getWritePacket();
+        packet.levelIndex    = m_game->getCurrentLevelIndex();
+        packet.interpolation = m_accumulatedTime / static_cast<float>(m_tickTime);
+        m_game->getCurrentLevel()->captureFramePacket(packet);
+        m_framePackets->publish();
+        std::chrono::high_resolution_clock::time_point simulationEnd = std::chrono::high_resolution_clock::now();
+        m_telemetry->record(TelemetryStage::SIMULATION, inputEnd, simulationEnd);
+
+        m_timeCounter += frameTime;
+
+        if (m_timeCounter > 500'000) {
+            // Frame times are the rendered ones since the start, busy time of both threads is measured against the same wall clock period
+            const LatencyHistogram& renderFrames = m_telemetry->getHistogram(TelemetryStage::RENDER_FRAME);
+            const float             period       = static_cast<float>(m_timeCounter);
+            char                    title[256];
+            sprintf_s(title, "Breakout! Frame p50: %.2fms, p99: %.2fms, p99.9: %.2fms, max: %.2fms at %.0f fps, missed deadlines: %llu, simulation: %.0f%%, "
+                      "rendering: %.0f%%",
+                      NANOSECONDS_TO_MILISECONDS(renderFrames.getPercentile(50.0)), NANOSECONDS_TO_MILISECONDS(renderFrames.getPercentile(99.0)),
+                      NANOSECONDS_TO_MILISECONDS(renderFrames.getPercentile(99.9)), NANOSECONDS_TO_MILISECONDS(renderFrames.getMax()),
+                      m_renderedFrameCount.exchange(0) * 1'000'000.0f / period, static_cast<unsigned long long>(m_framePacer->getMissedDeadlineCount()),
+                      100.0f * m_simulationBusyTime / period, 100.0f * m_renderBusyTime.exchange(0) / period);
+            m_renderer->setWindowTitle(title);
+            m_timeCounter        = 0;
+            m_simulationBusyTime = 0;
         }
-        case GameState::WIN_GAME: {
-            if (m_keyPressed[SDLK_SPACE]) {
-                initializeLevel(START_LIFE_COUNT, 0, 0);
-                m_stateTimeCounter = 0;
 
-                m_gameState = GameState::BEGIN_LEVEL;
-            } else if (m_keyPressed[SDLK_ESCAPE]) {
-                m_quit = true;
-            }
-            break;
+        // Zones are moved out of the thread buffers every frame, so the buffers never fill up
+        if (!m_tracePath.empty()) {
+            Profiler::collect();
         }
-    }
 
-    m_currentLevel->updateGPUData();
+        if (Telemetry::takeSaveRequest()) {
+            if (!m_telemetryPath.empty()) {
+                m_telemetry->save(m_telemetryPath.c_str());
+            }
+            if (!m_tracePath.empty()) {
+                Profiler::save(m_tracePath.c_str());
+            }
+        }
 
-    if (m_timeCounter > 500'000) {
-        char title[256];
-        sprintf_s(title, "Breakout! Frametime: %.2fms", MICROSECONDS_TO_MILISECONDS(m_timeCounter) / static_cast<float>(m_frameCount));
-        m_renderer->setWindowTitle(title);
-        m_timeCounter = 0;
-        m_frameCount  = 0;
+        m_simulationBusyTime += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(simulationEnd - frameStart).count());
+        m_framePacer->endFrame();
     }
 }
 
-void Breakout::initializeLevel(const uint32_t& lifeCount, const uint32_t& score, const uint32_t& levelIndex) {
-    m_score        = score;
-    m_lifeCount    = lifeCount;
-    m_currentLevel = m_levels[levelIndex].get();
-    m_currentLevel->load(m_lifeCount, m_score, levelIndex + 1);
-    m_currentLevel->setTitleVisibility(1.0f);
-    m_currentLevel->setTitle(TEXTURE_UI_LOADING_LEVEL);
-    m_stateTimeCounter  = 0;
-    m_currentLevelIndex = levelIndex;
-    m_gameState         = GameState::BEGIN_LEVEL;
+void Breakout::renderLoop() {
+    Profiler::setThreadName("render");
+    try {
+        // Level the render data is bound for, every level switch rebinds it since the levels share the GPU command buffers
+        uint32_t                                       boundLevelIndex = UINT32_MAX;
+        bool                                           firstFrame      = true;
+        std::chrono::high_resolution_clock::time_point previousRenderStart;
+        while (!m_quit) {
+            const FramePacket* packet = m_framePackets->acquire();
+            if (!packet) {
+                m_framePackets->waitForPacket(RENDER_THREAD_WAIT_TIMEOUT);
+                continue;
+            }
+            PROFILE_ZONE("Breakout::renderLoop");
+
+            std::chrono::high_resolution_clock::time_point renderStart = std::chrono::high_resolution_clock::now();
+            if (!firstFrame) {
+                m_telemetry->record(TelemetryStage::RENDER_FRAME, previousRenderStart, renderStart);
+            }
+            previousRenderStart = renderStart;
+            firstFrame          = false;
+
+            Level& level = *m_levels[packet->levelIndex];
+            if (packet->levelIndex != boundLevelIndex) {
+                level.bindRenderData(packet->levelIndex + 1);
+                boundLevelIndex = packet->levelIndex;
+            }
+            level.updateGPUData(*packet);
+            std::chrono::high_resolution_clock::time_point uploadEnd = std::chrono::high_resolution_clock::now();
+            m_telemetry->record(TelemetryStage::UPLOAD, renderStart, uploadEnd);
+
+            m_renderer->acquireImage();
+            std::chrono::high_resolution_clock::time_point acquireEnd = std::chrono::high_resolution_clock::now();
+            m_telemetry->record(TelemetryStage::ACQUIRE, uploadEnd, acquireEnd);
+
+            m_renderer->submitImage();
+            std::chrono::high_resolution_clock::time_point submitEnd = std::chrono::high_resolution_clock::now();
+            m_telemetry->record(TelemetryStage::SUBMIT, acquireEnd, submitEnd);
+
+            m_renderer->presentImage();
+            std::chrono::high_resolution_clock::time_point presentEnd = std::chrono::high_resolution_clock::now();
+            m_telemetry->record(TelemetryStage::PRESENT, submitEnd, presentEnd);
+
+            m_renderBusyTime += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(presentEnd - renderStart).count());
+            ++m_renderedFrameCount;
+        }
+    } catch (...) {
+        m_renderException = std::current_exception();
+        m_quit            = true;
+    }
 }
 
 void Breakout::pollEvents() {
+    PROFILE_ZONE("Breakout::pollEvents");
+
     SDL_Event sdlEvent;
     while (SDL_PollEvent(&sdlEvent)) {
         switch (sdlEvent.type) {
@@ -247,14 +272,17 @@ void Breakout::pollEvents() {
         }
     }
 
-    m_padControl = 0.0f;
+    m_input.padControl = 0.0f;
     if (m_keyPressed[SDLK_a]) {
-        m_padControl += -1.0f;
+        m_input.padControl += -1.0f;
     }
 
     if (m_keyPressed[SDLK_d]) {
-        m_padControl += 1.0f;
+        m_input.padControl += 1.0f;
     }
+
+    m_input.release = m_keyPressed[SDLK_SPACE];
+    m_input.quit    = m_keyPressed[SDLK_ESCAPE];
 }
 
 const uint32_t Breakout::getFrametime() {
@@ -264,8 +292,3 @@ const uint32_t Breakout::getFrametime() {
 
     return frameTime;
 }
-
-const float Breakout::fade(const int32_t& holdBefore, const int32_t& fadeTime, const uint32_t& currentStateTime) {
-    float value = static_cast<int32_t>(currentStateTime - holdBefore) / static_cast<float>(fadeTime) + (fadeTime > 0 ? 0.0f : 1.0f);
-    return std::clamp(value, 0.0f, 1.0f);
-}
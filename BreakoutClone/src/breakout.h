@@ -1,42 +1,55 @@
 #pragma once
-#include "level.h"
+#include "autoplayer.h"
+#include "framePacer.h"
+#include "framePacket.h"
+#include "game.h"
+#include "inputLog.h"
+#include "stateHashLog.h"
+#include "telemetry.h"
 
 #include "commonExternal.h"
 
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <memory>
 
 // In frames per second
 #define TARGET_FRAMERATE 144
 
-#define START_LIFE_COUNT 5
+// Upper bound of simulation steps run in a single frame, time beyond it is dropped instead of catching up
+#define MAX_TICKS_PER_FRAME 16
 
-#define BEGIN_LEVEL_BEFORE_FADE SECONDS_TO_MICROSECONDS(1)
-#define BEGIN_LEVEL_FADE        SECONDS_TO_MICROSECONDS(2)
-#define LOSE_GAME_FADE          SECONDS_TO_MICROSECONDS(3)
-#define LEVEL_WIN_FADE          SECONDS_TO_MICROSECONDS(3)
+// Render thread checks for shutdown at least this often while it waits for a frame packet, in microseconds
+#define RENDER_THREAD_WAIT_TIMEOUT 1000
 
-struct CollisionData;
-
-class Physics;
 class Renderer;
 class SoundManager;
 class TextureManager;
 
 /// <summary>
-/// States that the game can be in.
-/// </summary>
-enum class GameState { BEGIN_LEVEL, BALL_ATTACHED, PLAYING, LOSE_LIFE, LOSE_GAME, RESTART_SCREEN, WIN_LEVEL, WIN_GAME };
-
-/// <summary>
-/// Main class that initializes all the other components required for runing the game and manages the game state.
+/// Main class that initializes all the other components required for runing the game and drives the game with player input. The game is simulated on the
+/// main thread, which also handles the window events, and drawn on a render thread, so waiting for the GPU and the presentation never holds the simulation
+/// up. The threads only share frame packets, passed through a lock-free triple buffer.
 /// </summary>
 class Breakout {
   public:
     /// <summary>
-    /// Initializes renderer, texture manager, sound manager and physics engine. Loads data into uniform buffer and loads all levels.
-    /// </summary>
-    Breakout();
+    /// Initializes renderer, texture manager and sound manager. Loads data into uniform buffer, loads all levels and sets up the game on them.
+    /// </summary>
+    /// <param name="physicsMode">Number representation used by the physics calculations.</param>
+    /// <param name="inputLogPath">Path the player input is saved to when the game is shut down, nullptr records nothing.</param>
+    /// <param name="stateHashLogPath">Path the state hash of every simulation step is saved to when the game is shut down, nullptr records nothing.</param>
+    /// <param name="telemetryPath">Path the frame time percentiles are saved to when the game is shut down or Telemetry::requestSave is called, nullptr
+    /// saves nothing.</param>
+    /// <param name="tracePath">Path the zones recorded by the profiler are saved to when the game is shut down or Telemetry::requestSave is called,
+    /// nullptr records nothing.</param>
+    /// <param name="autoplay">Lets the autoplayer play the game in place of the player.</param>
+    /// <param name="targetFramerate">Frames per second the application will not run faster than, 0 leaves the framerate uncapped.</param>
+    /// <param name="pacingMode">When the frames wait for their deadline, after their frame packet is published or before the input is sampled.</param>
+    Breakout(const PhysicsMode& physicsMode = PhysicsMode::FLOATING_POINT, const char* inputLogPath = nullptr, const char* stateHashLogPath = nullptr,
+             const char* telemetryPath = nullptr, const char* tracePath = nullptr, const bool& autoplay = false,
+             const uint32_t& targetFramerate = TARGET_FRAMERATE, const PacingMode& pacingMode = PacingMode::FRAME_RATE);
     ~Breakout();
 
     /// <summary>
@@ -61,74 +74,109 @@ class Breakout {
     std::unique_ptr<SoundManager> m_soundManager;
 
     /// <summary>
-    /// Global physics reslover.
+    /// Game rules, played on the loaded levels.
     /// </summary>
-    std::unique_ptr<Physics> m_physics;
+    std::unique_ptr<Game> m_game;
 
     /// <summary>
-    /// Timestamp used to calculate sleep time and step time for physics.
+    /// Player input of every simulation step, recorded only if a path to save it to was given.
     /// </summary>
-    std::chrono::high_resolution_clock::time_point m_time;
+    std::unique_ptr<InputLog> m_inputLog;
 
     /// <summary>
-    /// Frame time targeted by the application. The application will not run faster than this.
+    /// Path the recorded player input is saved to.
     /// </summary>
-    uint32_t m_targetFrameTime = TARGET_FRAMERATE == 0 ? 0 : 1'000'000 / TARGET_FRAMERATE;
+    std::string m_inputLogPath = "";
 
     /// <summary>
-    /// Timer for fade in and fade out operations at the start of various game states.
+    /// State hash of every simulation step, recorded only if a path to save it to was given.
     /// </summary>
-    uint32_t m_stateTimeCounter = 0;
+    std::unique_ptr<StateHashLog> m_stateHashLog;
 
     /// <summary>
-    /// Time counter used for window title frametime updates.
+    /// Path the recorded state hashes are saved to.
     /// </summary>
-    uint32_t m_timeCounter = 0;
+    std::string m_stateHashLogPath = "";
+
+    /// <summary>
+    /// Histograms of the frame stage times of both threads.
+    /// </summary>
+    std::unique_ptr<Telemetry> m_telemetry;
+
+    /// <summary>
+    /// Path the frame time percentiles are saved to, empty saves nothing.
+    /// </summary>
+    std::string m_telemetryPath = "";
+
+    /// <summary>
+    /// Path the profiler trace is saved to, empty records nothing.
+    /// </summary>
+    std::string m_tracePath = "";
+
+    /// <summary>
+    /// Plays the game in place of the player if autoplay was asked for.
+    /// </summary>
+    std::unique_ptr<Autoplayer> m_autoplayer;
+
+    /// <summary>
+    /// Keeps the simulation frames to the target framerate.
+    /// </summary>
+    std::unique_ptr<FramePacer> m_framePacer;
+
+    /// <summary>
+    /// Hands the state of the simulated frames over to the render thread.
+    /// </summary>
+    std::unique_ptr<FramePacketBuffer> m_framePackets;
+
+    /// <summary>
+    /// Timestamp used to calculate step time for physics.
+    /// </summary>
+    std::chrono::high_resolution_clock::time_point m_time;
 
     /// <summary>
-    /// Counter of frames for calculating average frametime between window title updates
+    /// Duration of a single simulation step.
     /// </summary>
-    uint32_t m_frameCount = 0;
+    uint32_t m_tickTime = 1'000'000 / PHYSICS_TICK_RATE;
 
     /// <summary>
-    /// Boolean used to control when the game exits.
+    /// Time passed that has not been simulated yet.
     /// </summary>
-    bool m_quit = false;
+    uint32_t m_accumulatedTime = 0;
 
     /// <summary>
-    /// X-axis speed of the pad for the current frame.
+    /// Time counter used for window title updates.
     /// </summary>
-    float m_padControl = 0;
+    uint32_t m_timeCounter = 0;
 
     /// <summary>
-    /// Current direction of the ball, normalized.
+    /// Time the simulation thread spent working rather than waiting for the frame deadline since the last window title update, in microseconds.
     /// </summary>
-    glm::vec2 m_ballDirection = {0.0f, 0.0f};
+    uint32_t m_simulationBusyTime = 0;
 
     /// <summary>
-    /// Remaining player lives.
+    /// Time the render thread spent drawing frames rather than waiting for frame packets since the last window title update, in microseconds.
     /// </summary>
-    uint32_t m_lifeCount = START_LIFE_COUNT;
+    std::atomic<uint32_t> m_renderBusyTime = 0;
 
     /// <summary>
-    /// Current player score
+    /// Number of frames drawn by the render thread since the last window title update.
     /// </summary>
-    uint32_t m_score = 0;
+    std::atomic<uint32_t> m_renderedFrameCount = 0;
 
     /// <summary>
-    /// Current game state.
+    /// Exception the render thread stopped on, rethrown on the main thread once the render thread is joined.
     /// </summary>
-    GameState m_gameState = GameState::BEGIN_LEVEL;
+    std::exception_ptr m_renderException;
 
     /// <summary>
-    /// Pointer to currently active level.
+    /// Boolean used to control when the game exits, set by either thread.
     /// </summary>
-    Level* m_currentLevel = nullptr;
+    std::atomic<bool> m_quit = false;
 
     /// <summary>
-    /// Index of the currently active level.
+    /// Player input for the current frame.
     /// </summary>
-    uint32_t m_currentLevelIndex = 0;
+    GameInput m_input = {};
 
     /// <summary>
     /// Vector of all loaded levels.
@@ -141,35 +189,28 @@ class Breakout {
     std::map<SDL_Keycode, bool> m_keyPressed = {};
 
     /// <summary>
-    /// Vector of collision data for the current frame.
-    /// </summary>
-    std::vector<CollisionData> m_collisionInfo = {};
-
-    /// <summary>
-    /// Loads all levels found in levels folder, alphabetically.
+    /// Loads all levels found in levels folder, alphabetically, the same order the headless tools use.
     /// </summary>
     void loadAllLevels();
 
     /// <summary>
-    /// Initializes the game and runs the game loop for each frame until the game is shutdown.
+    /// Initializes the game, starts the render thread and runs the simulation loop until the game is shutdown. Rethrows the exception the render thread
+    /// stopped on, if any.
     /// </summary>
     void gameLoop();
 
     /// <summary>
-    /// Runs a single frame worth of game logic.
+    /// Runs the simulation for each frame on the main thread and publishes the frame packets, until the game is shutdown.
     /// </summary>
-    void doGame(const uint32_t& frameTime);
+    void simulationLoop();
 
     /// <summary>
-    /// Sets up a level, making it start next iteration of the game loop.
+    /// Draws the latest published frame packet on the render thread until the game is shutdown. Waits for a new packet when it has drawn the latest one.
     /// </summary>
-    /// <param name="lifeCount">Amount of lives to be initially shown on screen.</param>
-    /// <param name="score">Score to be initially shown on screen.</param>
-    /// <param name="levelIndex">Ordinal number of the level to be initially shown on screen.</param>
-    void initializeLevel(const uint32_t& lifeCount, const uint32_t& score, const uint32_t& levelIndex);
+    void renderLoop();
 
     /// <summary>
-    /// Stores key presses and handles pad input.
+    /// Stores key presses and translates them into game input.
     /// </summary>
     void pollEvents();
 
@@ -178,13 +219,4 @@ class Breakout {
     /// </summary>
     /// <returns>Time passed since it was previously called in microseconds.</returns>
     const uint32_t getFrametime();
-
-    /// <summary>
-    /// Calculates an alpha value based on time and parameters given.
-    /// </summary>
-    /// <param name="holdBefore">Amount of time to keep alpha clamped to initial value (0.0f or 1.0f, see fadeTime param) before fading in or out.</param>
-    /// <param name="fadeTime">Time it takes to fade from visible to black. Negative value fades from black to visible.</param>
-    /// <param name="currentStateTime">Timestamp from the start for which alpha value is to be calculated.</param>
-    /// <returns>Alpha value for fade at the input timestamp.</returns>
-    const float fade(const int32_t& holdBefore, const int32_t& fadeTime, const uint32_t& currentStateTime);
 };
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "common.h"
+#include "commonExternal.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Fewest buckets of a spatial hash, the bucket count is a power of two at least twice the number of cells the boxes cover
+#define MIN_BRICK_HASH_BUCKET_COUNT 16
+
+// Marks the end of a bucket list and boxes that are not in the hash
+#define BRICK_HASH_NONE UINT32_MAX
+
+/// <summary>
+/// Spatial hash of axis aligned boxes of any size and position. The plane is cut into cells, every cell a box overlaps holds an entry for it, and the
+/// entries of a cell are linked into the list of the bucket the cell hashes to. Inserting and removing a box touches only the cells it overlaps, and
+/// looking up a region touches only the cells the region overlaps, however the other boxes are laid out. Lives in the level data that is copied on level
+/// reset, so it is kept in flat vectors.
+/// </summary>
+class BrickHash {
+  public:
+    /// <summary>
+    /// Removes all boxes and sets up the cells and the buckets.
+    /// </summary>
+    /// <param name="origin">Corner of the cell at cell coordinates 0, 0.</param>
+    /// <param name="cellDimensions">Dimensions of a single cell, best about the size of a typical box.</param>
+    /// <param name="cellCapacity">Expected number of cells covered by all the boxes together, picks the number of buckets.</param>
+    void reset(const glm::vec2& origin, const glm::vec2& cellDimensions, const uint32_t& cellCapacity) {
+        uint32_t bucketCount = MIN_BRICK_HASH_BUCKET_COUNT;
+        m_bucketShift        = 32 - countTrailingZeros(bucketCount);
+        while (bucketCount < 2 * cellCapacity) {
+            bucketCount <<= 1;
+            --m_bucketShift;
+        }
+
+        m_origin         = origin;
+        m_cellDimensions = cellDimensions;
+        m_count          = 0;
+        m_buckets.assign(bucketCount, BRICK_HASH_NONE);
+        m_entries.clear();
+        m_entries.reserve(cellCapacity);
+        m_boxes.clear();
+    }
+
+    /// <summary>
+    /// Adds a box to the hash, an entry for each cell it overlaps.
+    /// </summary>
+    /// <param name="id">Id of the box, returned by lookups. A box with the same id must not be in the hash already.</param>
+    /// <param name="boxMin">Corner of the box with the smallest coordinates.</param>
+    /// <param name="boxMax">Corner of the box with the largest coordinates.</param>
+    void insert(const uint32_t& id, const glm::vec2& boxMin, const glm::vec2& boxMax) {
+        if (id >= m_boxes.size()) {
+            m_boxes.resize(id + 1);
+        }
+        assert(!m_boxes[id].linked);
+
+        int32_t firstX, firstY, lastX, lastY;
+        getCells(boxMin, boxMax, firstX, firstY, lastX, lastY);
+
+        Box& box       = m_boxes[id];
+        box.firstCellX = firstX;
+        box.firstCellY = firstY;
+        box.firstEntry = static_cast<uint32_t>(m_entries.size());
+        box.entryCount = static_cast<uint32_t>((lastX - firstX + 1) * (lastY - firstY + 1));
+        box.linked     = true;
+
+        for (int32_t y = firstY; y <= lastY; ++y) {
+            for (int32_t x = firstX; x <= lastX; ++x) {
+                Entry entry;
+                entry.cellX  = x;
+                entry.cellY  = y;
+                entry.id     = id;
+                entry.bucket = getBucket(x, y);
+                entry.next   = m_buckets[entry.bucket];
+
+                const uint32_t entryIndex = static_cast<uint32_t>(m_entries.size());
+                if (entry.next != BRICK_HASH_NONE) {
+                    m_entries[entry.next].previous = entryIndex;
+                }
+                m_buckets[entry.bucket] = entryIndex;
+                m_entries.push_back(entry);
+            }
+        }
+
+        ++m_count;
+    }
+
+    /// <summary>
+    /// Takes a box out of the hash, unlinking its entries from their buckets. Nothing is freed, the entries stay unused until the box is relinked or the hash
+    /// is reset.
+    /// </summary>
+    /// <param name="id">Id of the box, boxes not in the hash are ignored.</param>
+    void remove(const uint32_t& id) {
+        if (id >= m_boxes.size() || !m_boxes[id].linked) {
+            return;
+        }
+
+        Box& box = m_boxes[id];
+        for (uint32_t entryIndex = box.firstEntry; entryIndex < box.firstEntry + box.entryCount; ++entryIndex) {
+            const Entry& entry = m_entries[entryIndex];
+            if (entry.previous != BRICK_HASH_NONE) {
+                m_entries[entry.previous].next = entry.next;
+            } else {
+                m_buckets[entry.bucket] = entry.next;
+            }
+            if (entry.next != BRICK_HASH_NONE) {
+                m_entries[entry.next].previous = entry.previous;
+            }
+        }
+
+        box.linked = false;
+        --m_count;
+    }
+
+    /// <summary>
+    /// Rebuilds the bucket lists from the entries the boxes were last inserted with, keeping only the boxes the filter picks. Entries are linked in the
+    /// order they were inserted, so the lists come out as if the boxes left out had been removed one by one, and lookups visit the boxes in the same order.
+    /// Nothing is allocated.
+    /// </summary>
+    /// <param name="keep">Function taking the id of a box, returning true if the box is to be in the hash.</param>
+    template <typename Filter>
+    void relink(const Filter& keep) {
+        std::fill(m_buckets.begin(), m_buckets.end(), BRICK_HASH_NONE);
+        m_count = 0;
+        for (uint32_t id = 0; id < m_boxes.size(); ++id) {
+            Box& box   = m_boxes[id];
+            box.linked = box.entryCount > 0 && keep(id);
+            m_count += box.linked ? 1 : 0;
+        }
+
+        for (uint32_t entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex) {
+            Entry&     entry = m_entries[entryIndex];
+            const Box& box   = m_boxes[entry.id];
+
+            // Entries older than the first entry of their box were left behind when the box was inserted again
+            if (!box.linked || entryIndex < box.firstEntry) {
+                continue;
+            }
+
+            entry.previous = BRICK_HASH_NONE;
+            entry.next     = m_buckets[entry.bucket];
+            if (entry.next != BRICK_HASH_NONE) {
+                m_entries[entry.next].previous = entryIndex;
+            }
+            m_buckets[entry.bucket] = entryIndex;
+        }
+    }
+
+    /// <summary>
+    /// Calls the visitor once for every box that shares a cell with the region. Boxes that share a cell without overlapping the region are visited as
+    /// well, the visitor does the exact test.
+    /// </summary>
+    /// <param name="regionMin">Corner of the region with the smallest coordinates.</param>
+    /// <param name="regionMax">Corner of the region with the largest coordinates.</param>
+    /// <param name="visit">Function taking the id of a box.</param>
+    template <typename Visitor>
+    void query(const glm::vec2& regionMin, const glm::vec2& regionMax, const Visitor& visit) const {
+        if (m_count == 0) {
+            return;
+        }
+
+        int32_t firstX, firstY, lastX, lastY;
+        getCells(regionMin, regionMax, firstX, firstY, lastX, lastY);
+
+        for (int32_t y = firstY; y <= lastY; ++y) {
+            for (int32_t x = firstX; x <= lastX; ++x) {
+                for (uint32_t entryIndex = m_buckets[getBucket(x, y)]; entryIndex != BRICK_HASH_NONE; entryIndex = m_entries[entryIndex].next) {
+                    const Entry& entry = m_entries[entryIndex];
+                    const Box&   box   = m_boxes[entry.id];
+
+                    // Other cells may hash to the same bucket, and a box overlapping several cells of the region is only visited from the first one
+                    if (entry.cellX == x && entry.cellY == y && x == std::max(firstX, box.firstCellX) && y == std::max(firstY, box.firstCellY)) {
+                        visit(entry.id);
+                    }
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Getter for the number of boxes in the hash.
+    /// </summary>
+    /// <returns>Number of boxes in the hash.</returns>
+    const uint32_t& getCount() const { return m_count; }
+
+  private:
+    /// <summary>
+    /// Entry of a box in a single cell, linked into the list of the bucket of the cell.
+    /// </summary>
+    struct Entry {
+        /// <summary>
+        /// Horizontal cell coordinate of the cell.
+        /// </summary>
+        int32_t cellX = 0;
+
+        /// <summary>
+        /// Vertical cell coordinate of the cell.
+        /// </summary>
+        int32_t cellY = 0;
+
+        /// <summary>
+        /// Id of the box.
+        /// </summary>
+        uint32_t id = 0;
+
+        /// <summary>
+        /// Bucket the cell hashes to.
+        /// </summary>
+        uint32_t bucket = 0;
+
+        /// <summary>
+        /// Index of the previous entry in the bucket list, BRICK_HASH_NONE for the first entry.
+        /// </summary>
+        uint32_t previous = BRICK_HASH_NONE;
+
+        /// <summary>
+        /// Index of the next entry in the bucket list, BRICK_HASH_NONE for the last entry.
+        /// </summary>
+        uint32_t next = BRICK_HASH_NONE;
+    };
+
+    /// <summary>
+    /// Entries of a single box, stored one after another.
+    /// </summary>
+    struct Box {
+        /// <summary>
+        /// Horizontal cell coordinate of the first cell the box overlaps.
+        /// </summary>
+        int32_t firstCellX = 0;
+
+        /// <summary>
+        /// Vertical cell coordinate of the first cell the box overlaps.
+        /// </summary>
+        int32_t firstCellY = 0;
+
+        /// <summary>
+        /// Index of the first entry of the box.
+        /// </summary>
+        uint32_t firstEntry = 0;
+
+        /// <summary>
+        /// Number of entries of the box, 0 if the box was never inserted.
+        /// </summary>
+        uint32_t entryCount = 0;
+
+        /// <summary>
+        /// True while the entries of the box are linked into their buckets.
+        /// </summary>
+        bool linked = false;
+    };
+
+    /// <summary>
+    /// Corner of the cell at cell coordinates 0, 0.
+    /// </summary>
+    glm::vec2 m_origin = {0.0f, 0.0f};
+
+    /// <summary>
+    /// Dimensions of a single cell.
+    /// </summary>
+    glm::vec2 m_cellDimensions = {1.0f, 1.0f};
+
+    /// <summary>
+    /// Shift taking the top bits of the cell hash as the bucket index.
+    /// </summary>
+    uint32_t m_bucketShift = 32;
+
+    /// <summary>
+    /// Number of boxes in the hash.
+    /// </summary>
+    uint32_t m_count = 0;
+
+    /// <summary>
+    /// Index of the first entry of each bucket list, BRICK_HASH_NONE for empty buckets.
+    /// </summary>
+    std::vector<uint32_t> m_buckets;
+
+    /// <summary>
+    /// Entries of all boxes ever inserted since the last reset.
+    /// </summary>
+    std::vector<Entry> m_entries;
+
+    /// <summary>
+    /// Entries of the boxes, indexed by the box id.
+    /// </summary>
+    std::vector<Box> m_boxes;
+
+    /// <summary>
+    /// Finds the range of cells a region overlaps.
+    /// </summary>
+    /// <param name="regionMin">Corner of the region with the smallest coordinates.</param>
+    /// <param name="regionMax">Corner of the region with the largest coordinates.</param>
+    /// <param name="firstX">Horizontal cell coordinate of the first overlapped cell.</param>
+    /// <param name="firstY">Vertical cell coordinate of the first overlapped cell.</param>
+    /// <param name="lastX">Horizontal cell coordinate of the last overlapped cell.</param>
+    /// <param name="lastY">Vertical cell coordinate of the last overlapped cell.</param>
+    void getCells(const glm::vec2& regionMin, const glm::vec2& regionMax, int32_t& firstX, int32_t& firstY, int32_t& lastX, int32_t& lastY) const {
+        glm::vec2 firstCell = glm::floor((regionMin - m_origin) / m_cellDimensions);
+        glm::vec2 lastCell  = glm::floor((regionMax - m_origin) / m_cellDimensions);
+        firstX              = static_cast<int32_t>(firstCell.x);
+        firstY              = static_cast<int32_t>(firstCell.y);
+        lastX               = static_cast<int32_t>(lastCell.x);
+        lastY               = static_cast<int32_t>(lastCell.y);
+    }
+
+    /// <summary>
+    /// Hashes cell coordinates to a bucket, taking the top bits of a multiplicative hash.
+    /// </summary>
+    /// <param name="x">Horizontal cell coordinate.</param>
+    /// <param name="y">Vertical cell coordinate.</param>
+    /// <returns>Index of the bucket of the cell.</returns>
+    uint32_t getBucket(const int32_t& x, const int32_t& y) const {
+        return ((static_cast<uint32_t>(x) * 0x9E3779B1u) ^ (static_cast<uint32_t>(y) * 0x85EBCA77u)) >> m_bucketShift;
+    }
+};
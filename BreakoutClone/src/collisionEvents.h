@@ -0,0 +1,129 @@
+#pragma once
+
+#include "common.h"
+
+// Most collision events a single simulation step can record, a power of two so the positions wrap with a mask. Every ball records at most one event per
+// sub-step and one more when it is lost, so a step of the most balls taking the most sub-steps fits
+#define COLLISION_EVENT_CAPACITY (1 << 16)
+
+/// <summary>
+/// Object that the collision occured with. BALL_LOST marks a ball that left the play area through the bottom.
+/// </summary>
+enum class CollisionType { NONE, BRICK, PAD, WALL, BALL_LOST };
+
+/// <summary>
+/// Structure holding information on a collision.
+/// </summary>
+struct CollisionData {
+    /// <summary>
+    /// Object collided with.
+    /// </summary>
+    CollisionType type = CollisionType::NONE;
+
+    /// <summary>
+    /// Index of the brick relative to the first brick, only applicable for CollisionType::BRICK.
+    /// </summary>
+    uint32_t hitBrickIndex = 0;
+
+    /// <summary>
+    /// Id of the brick type of the hit brick, only applicable for CollisionType::BRICK.
+    /// </summary>
+    uint32_t brickTypeId = 0;
+
+    /// <summary>
+    /// Index of the ball that collided, relative to the first ball.
+    /// </summary>
+    uint32_t ballIndex = 0;
+};
+
+/// <summary>
+/// Ring of collision events with a fixed capacity, allocated once with its owner. Physics pushes the events of a simulation step, consumers read them in
+/// order in a single pass. Events pushed while the ring is full are dropped and counted, which the capacity rules out for physics steps.
+/// </summary>
+class CollisionEventRing {
+  public:
+    static_assert((COLLISION_EVENT_CAPACITY & (COLLISION_EVENT_CAPACITY - 1)) == 0, "Collision event capacity must be a power of two!");
+
+    /// <summary>
+    /// Appends an event after the newest one.
+    /// </summary>
+    /// <param name="event">Event to be appended.</param>
+    /// <returns>False if the ring is full and the event was dropped, true otherwise.</returns>
+    bool push(const CollisionData& event) {
+        if (m_count == COLLISION_EVENT_CAPACITY) {
+            ++m_droppedCount;
+            return false;
+        }
+
+        m_events[(m_head + m_count) & (COLLISION_EVENT_CAPACITY - 1)] = event;
+        ++m_count;
+        return true;
+    }
+
+    /// <summary>
+    /// Removes the oldest event.
+    /// </summary>
+    /// <param name="event">Removed event, only applicable if an event was removed.</param>
+    /// <returns>False if the ring is empty, true otherwise.</returns>
+    bool pop(CollisionData& event) {
+        if (m_count == 0) {
+            return false;
+        }
+
+        event  = m_events[m_head];
+        m_head = (m_head + 1) & (COLLISION_EVENT_CAPACITY - 1);
+        --m_count;
+        return true;
+    }
+
+    /// <summary>
+    /// Removes all events. The dropped event count is kept.
+    /// </summary>
+    void clear() {
+        m_head  = 0;
+        m_count = 0;
+    }
+
+    /// <summary>
+    /// Getter for the number of events in the ring.
+    /// </summary>
+    /// <returns>Number of events in the ring.</returns>
+    const uint32_t& getCount() const { return m_count; }
+
+    /// <summary>
+    /// Getter for the number of events dropped because the ring was full.
+    /// </summary>
+    /// <returns>Number of events dropped since the ring was created.</returns>
+    const uint64_t& getDroppedCount() const { return m_droppedCount; }
+
+    /// <summary>
+    /// Reads an event without removing it.
+    /// </summary>
+    /// <param name="index">Position of the event, 0 being the oldest. Must be less than the event count.</param>
+    /// <returns>The event at the position.</returns>
+    const CollisionData& operator[](const uint32_t& index) const {
+        assert(index < m_count);
+        return m_events[(m_head + index) & (COLLISION_EVENT_CAPACITY - 1)];
+    }
+
+  private:
+    /// <summary>
+    /// Storage of the events, on the heap since it is too large for the stack.
+    /// </summary>
+    std::vector<CollisionData> m_events = std::vector<CollisionData>(COLLISION_EVENT_CAPACITY);
+
+    /// <summary>
+    /// Position of the oldest event in the storage.
+    /// </summary>
+    uint32_t m_head = 0;
+
+    /// <summary>
+    /// Number of events in the ring.
+    /// </summary>
+    uint32_t m_count = 0;
+
+    /// <summary>
+    /// Number of events dropped because the ring was full.
+    /// </summary>
+    uint64_t m_droppedCount = 0;
+};
@@ -2,6 +2,7 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -11,8 +12,73 @@
 /// Ensures that shared GLSL structures are compiled for C++
 #define CPP_SHADER_STRUCTURE
 
+// Level layout is derived from the window size, so headless builds use it as well
+#define WINDOW_WIDTH  1920
+#define WINDOW_HEIGHT 1080
+
 #define VECTOR_SIZE_IN_BYTES(vector) (static_cast<uint32_t>(vector.size()) * sizeof(vector[0]))
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// <summary>
+/// Returns the index of the lowest set bit. The value must not be zero.
+/// </summary>
+inline uint32_t countTrailingZeros(const uint64_t& value) {
+    assert(value != 0);
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
+/// <summary>
+/// Returns the index of the highest set bit. The value must not be zero.
+/// </summary>
+/// <param name="value">Value to be scanned.</param>
+/// <returns>Index of the highest set bit.</returns>
+inline uint32_t highestSetBit(const uint64_t& value) {
+    assert(value != 0);
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(63 - __builtin_clzll(value));
+#endif
+}
+
+/// <summary>
+/// Mixes a value into a hash with the splitmix64 finalizer, so hashes of states differing in a single bit differ in about half of their bits.
+/// </summary>
+/// <param name="hash">Hash to be mixed into.</param>
+/// <param name="value">Value to be mixed in.</param>
+/// <returns>The combined hash.</returns>
+inline uint64_t hashCombine(const uint64_t& hash, const uint64_t& value) {
+    uint64_t mixed = hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+    mixed          = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    mixed          = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+    return mixed ^ (mixed >> 31);
+}
+
+/// <summary>
+/// Packs two 32 bit values into a single 64 bit value, to be hashed together.
+/// </summary>
+inline uint64_t packPair(const uint32_t& low, const uint32_t& high) { return low | static_cast<uint64_t>(high) << 32; }
+
+/// <summary>
+/// Returns the bits of a float, so floats can be hashed exactly.
+/// </summary>
+inline uint32_t floatBits(const float& value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
 #ifdef _DEBUG
 #define VALIDATION_ENABLED
 
@@ -5,8 +5,11 @@
 #pragma warning(push, 0)
 #pragma warning(disable : 26819) // Dereferencing NULL pointer.'*' contains the same NULL value as '*' did.
 
+// Headless builds run without a window, GPU or sound
+#ifndef BREAKOUT_HEADLESS
 #include "SDL.h"
 #include "SDL_vulkan.h"
+#endif
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_XYZW_ONLY
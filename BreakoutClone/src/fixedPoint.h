@@ -0,0 +1,126 @@
+#pragma once
+
+#include "common.h"
+#include "commonExternal.h"
+
+#include <cmath>
+
+// Q16.16 numbers kept in 64 bits, so the product of two of them fits before it is scaled back
+#define FIXED_FRACTION_BITS 16
+#define FIXED_ONE           (1ll << FIXED_FRACTION_BITS)
+
+/// <summary>
+/// Fixed point number with FIXED_FRACTION_BITS fractional bits.
+/// </summary>
+typedef int64_t Fixed;
+
+/// <summary>
+/// Two dimensional vector of fixed point numbers.
+/// </summary>
+struct FixedVec2 {
+    /// <summary>
+    /// X component.
+    /// </summary>
+    Fixed x = 0;
+
+    /// <summary>
+    /// Y component.
+    /// </summary>
+    Fixed y = 0;
+};
+
+/// <summary>
+/// Converts a float to the nearest fixed point number, halfway cases rounded away from zero.
+/// </summary>
+inline Fixed toFixed(const float& value) { return static_cast<Fixed>(std::llround(static_cast<double>(value) * FIXED_ONE)); }
+
+/// <summary>
+/// Converts a float vector to the nearest fixed point vector.
+/// </summary>
+inline FixedVec2 toFixed(const glm::vec2& value) { return {toFixed(value.x), toFixed(value.y)}; }
+
+/// <summary>
+/// Converts a fixed point number to the nearest float.
+/// </summary>
+inline float toFloat(const Fixed& value) { return static_cast<float>(static_cast<double>(value) / FIXED_ONE); }
+
+/// <summary>
+/// Converts a fixed point vector to the nearest float vector.
+/// </summary>
+inline glm::vec2 toFloat(const FixedVec2& value) { return {toFloat(value.x), toFloat(value.y)}; }
+
+/// <summary>
+/// Multiplies two fixed point numbers, truncating the result towards zero.
+/// </summary>
+inline Fixed fixedMultiply(const Fixed& first, const Fixed& second) { return first * second / FIXED_ONE; }
+
+/// <summary>
+/// Divides two fixed point numbers, truncating the result towards zero. The divisor must not be zero.
+/// </summary>
+inline Fixed fixedDivide(const Fixed& dividend, const Fixed& divisor) { return dividend * FIXED_ONE / divisor; }
+
+/// <summary>
+/// Converts a speed in pixels per microsecond to fixed point pixels per second. Speeds are far below a pixel per microsecond, so only the larger unit
+/// keeps enough fractional bits.
+/// </summary>
+inline Fixed toFixedSpeed(const float& speed /*pixels per microsecond*/) { return toFixed(speed * 1'000'000.0f); }
+
+/// <summary>
+/// Distance covered at a fixed point speed in pixels per second over a time, truncated towards zero.
+/// </summary>
+inline Fixed fixedTravel(const Fixed& speed /*pixels per second*/, const uint32_t& time /*microseconds*/) { return speed * time / 1'000'000; }
+
+/// <summary>
+/// Integer square root, rounded down.
+/// </summary>
+inline uint64_t integerSqrt(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit    = 1ull << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return result;
+}
+
+/// <summary>
+/// Square root of a non-negative fixed point number, rounded down.
+/// </summary>
+inline Fixed fixedSqrt(const Fixed& value) { return static_cast<Fixed>(integerSqrt(static_cast<uint64_t>(value) << FIXED_FRACTION_BITS)); }
+
+/// <summary>
+/// Dot product of two fixed point vectors.
+/// </summary>
+inline Fixed fixedDot(const FixedVec2& first, const FixedVec2& second) { return (first.x * second.x + first.y * second.y) / FIXED_ONE; }
+
+/// <summary>
+/// Scales the vector to unit length. Zero vectors are returned unchanged.
+/// </summary>
+inline FixedVec2 fixedNormalize(const FixedVec2& value) {
+    // The squared length keeps all 32 fractional bits of the products so its square root has 16 of them
+    Fixed length = static_cast<Fixed>(integerSqrt(static_cast<uint64_t>(value.x * value.x + value.y * value.y)));
+    if (length == 0) {
+        return value;
+    }
+    return {fixedDivide(value.x, length), fixedDivide(value.y, length)};
+}
+
+/// <summary>
+/// Compares two fixed point vectors component-wise.
+/// </summary>
+inline bool operator==(const FixedVec2& first, const FixedVec2& second) { return first.x == second.x && first.y == second.y; }
+
+/// <summary>
+/// Compares two fixed point vectors component-wise.
+/// </summary>
+inline bool operator!=(const FixedVec2& first, const FixedVec2& second) { return !(first == second); }
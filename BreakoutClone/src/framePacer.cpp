@@ -0,0 +1,74 @@
+#include "framePacer.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <thread>
+
+FramePacer::FramePacer(const uint32_t& targetFrameTime, const PacingMode& mode) : m_targetFrameTime(targetFrameTime), m_mode(mode) {}
+
+void FramePacer::beginFrame() {
+    if (m_targetFrameTime == 0) {
+        return;
+    }
+
+    if (!m_started) {
+        m_deadline = std::chrono::high_resolution_clock::now() + std::chrono::microseconds(m_targetFrameTime);
+        m_started  = true;
+    }
+
+    if (m_mode == PacingMode::LATENCY) {
+        waitUntil(m_deadline - std::chrono::microseconds(m_frameWork + FRAME_PACER_LATENCY_SLACK));
+    }
+    m_frameStart = std::chrono::high_resolution_clock::now();
+}
+
+void FramePacer::endFrame() {
+    ++m_frameCount;
+    if (m_targetFrameTime == 0) {
+        return;
+    }
+
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+
+    uint32_t frameWork = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - m_frameStart).count());
+    m_frameWork        = std::max(frameWork, m_frameWork - (m_frameWork >> FRAME_PACER_DECAY_SHIFT));
+
+    // A late frame starts a new timeline, catching up would only bunch the frames that follow
+    if (now > m_deadline) {
+        uint32_t lateness = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - m_deadline).count());
+        m_maxLateness     = std::max(m_maxLateness, lateness);
+        ++m_missedDeadlineCount;
+        m_deadline = now + std::chrono::microseconds(m_targetFrameTime);
+        return;
+    }
+
+    if (m_mode == PacingMode::FRAME_RATE) {
+        waitUntil(m_deadline);
+    }
+    m_deadline += std::chrono::microseconds(m_targetFrameTime);
+}
+
+const uint64_t& FramePacer::getFrameCount() const { return m_frameCount; }
+
+const uint64_t& FramePacer::getMissedDeadlineCount() const { return m_missedDeadlineCount; }
+
+const uint32_t& FramePacer::getMaxLateness() const { return m_maxLateness; }
+
+void FramePacer::waitUntil(const std::chrono::high_resolution_clock::time_point& time) {
+    PROFILE_ZONE("FramePacer::waitUntil");
+
+    std::chrono::high_resolution_clock::time_point sleepEnd = time - std::chrono::microseconds(m_spinMargin);
+    if (std::chrono::high_resolution_clock::now() < sleepEnd) {
+        std::this_thread::sleep_until(sleepEnd);
+
+        // Timer granularity makes sleeps overshoot, the margin keeps room for the largest recent overshoot
+        int64_t  overshoot = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - sleepEnd).count();
+        uint32_t margin    = static_cast<uint32_t>(std::max<int64_t>(overshoot, 0)) + FRAME_PACER_MIN_SPIN_MARGIN;
+        m_spinMargin       = std::max(margin, m_spinMargin - (m_spinMargin >> FRAME_PACER_DECAY_SHIFT));
+    }
+
+    while (std::chrono::high_resolution_clock::now() < time) {
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "common.h"
+
+#include <chrono>
+
+// Sleep ends this long before a deadline until the pacer has seen how much the sleeps overshoot, the rest of the wait is spun, in microseconds
+#define FRAME_PACER_INITIAL_SPIN_MARGIN 2000
+
+// Sleep always ends at least this long before a deadline, in microseconds
+#define FRAME_PACER_MIN_SPIN_MARGIN 200
+
+// In latency mode frames start this much earlier than the slowest recent frame needs to finish by the deadline, in microseconds
+#define FRAME_PACER_LATENCY_SLACK 500
+
+// Tracked maxima of the sleep overshoot and the frame work lose 1 / 2^shift of their value every frame, so they follow the recent frames
+#define FRAME_PACER_DECAY_SHIFT 6
+
+/// <summary>
+/// When the frame pacer waits for the frame deadline. Frames are paced on the simulation thread and end once their frame packet is published, the render
+/// thread draws and presents the latest packet on its own timeline.
+/// FRAME_RATE waits after the packet is published, so frames start right after the previous deadline and the input is sampled early in the frame.
+/// LATENCY waits before the frame starts, as long as the recent frames leave room for, so the input is sampled as late as possible before the packet is
+/// published. The time the render thread takes to pick the packet up and present it is not shortened.
+/// </summary>
+enum class PacingMode { FRAME_RATE, LATENCY };
+
+/// <summary>
+/// Keeps frames to a target frame time. Deadlines follow each other a frame time apart, so the frame rate does not drift with the wait precision. Waiting
+/// sleeps until shortly before the deadline and spins on the clock for the rest, the sleep ending early enough to cover the largest overshoot the
+/// system's timer showed lately. Frames that finish past their deadline are counted as missed and start a new timeline instead of rushing to catch up.
+/// </summary>
+class FramePacer {
+  public:
+    /// <summary>
+    /// Creates the frame pacer.
+    /// </summary>
+    /// <param name="targetFrameTime">Frame time targeted in microseconds, 0 never waits.</param>
+    /// <param name="mode">When the pacer waits for the frame deadline.</param>
+    FramePacer(const uint32_t& targetFrameTime, const PacingMode& mode);
+
+    /// <summary>
+    /// Marks the start of a frame, called before the input is sampled. In latency mode waits until the latest time the frame can start at and still be
+    /// done by its deadline.
+    /// </summary>
+    void beginFrame();
+
+    /// <summary>
+    /// Marks the end of a frame, called after its frame packet is published. Checks the frame against its deadline and in frame rate mode waits for it.
+    /// </summary>
+    void endFrame();
+
+    /// <summary>
+    /// Getter for the number of paced frames.
+    /// </summary>
+    /// <returns>Number of frames ended since the pacer was created.</returns>
+    const uint64_t& getFrameCount() const;
+
+    /// <summary>
+    /// Getter for the number of frames that missed their deadline.
+    /// </summary>
+    /// <returns>Number of frames that ended past their deadline since the pacer was created.</returns>
+    const uint64_t& getMissedDeadlineCount() const;
+
+    /// <summary>
+    /// Getter for the largest deadline miss.
+    /// </summary>
+    /// <returns>Longest time a frame ended past its deadline in microseconds.</returns>
+    const uint32_t& getMaxLateness() const;
+
+  private:
+    /// <summary>
+    /// Frame time targeted in microseconds.
+    /// </summary>
+    uint32_t m_targetFrameTime;
+
+    /// <summary>
+    /// When the pacer waits for the frame deadline.
+    /// </summary>
+    PacingMode m_mode;
+
+    /// <summary>
+    /// Time before a deadline sleeping ends at, in microseconds.
+    /// </summary>
+    uint32_t m_spinMargin = FRAME_PACER_INITIAL_SPIN_MARGIN;
+
+    /// <summary>
+    /// Recent maximum of the time between the start and the end of a frame, in microseconds.
+    /// </summary>
+    uint32_t m_frameWork = 0;
+
+    /// <summary>
+    /// Deadline of the current frame.
+    /// </summary>
+    std::chrono::high_resolution_clock::time_point m_deadline;
+
+    /// <summary>
+    /// Start of the current frame.
+    /// </summary>
+    std::chrono::high_resolution_clock::time_point m_frameStart;
+
+    /// <summary>
+    /// True once the first frame has started and set the first deadline.
+    /// </summary>
+    bool m_started = false;
+
+    /// <summary>
+    /// Number of frames ended.
+    /// </summary>
+    uint64_t m_frameCount = 0;
+
+    /// <summary>
+    /// Number of frames that ended past their deadline.
+    /// </summary>
+    uint64_t m_missedDeadlineCount = 0;
+
+    /// <summary>
+    /// Longest time a frame ended past its deadline in microseconds.
+    /// </summary>
+    uint32_t m_maxLateness = 0;
+
+    /// <summary>
+    /// Sleeps until shortly before the given time, then spins on the clock until it is reached. The sleep overshoot is measured to adapt the spin margin.
+    /// </summary>
+    /// <param name="time">Time to wait until.</param>
+    void waitUntil(const std::chrono::high_resolution_clock::time_point& time);
+};
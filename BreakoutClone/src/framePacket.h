@@ -0,0 +1,128 @@
+#pragma once
+
+#include "level.h"
+#include "profiler.h"
+
+#include "common.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Marks the packet in the middle slot of the triple buffer as published and not yet taken by the render thread
+#define FRAME_PACKET_FRESH_BIT 0x4
+
+// Masks the slot index out of the middle slot of the triple buffer
+#define FRAME_PACKET_SLOT_MASK 0x3
+
+/// <summary>
+/// Everything the render thread needs to draw a frame, produced by the simulation thread. The packet holds a full snapshot of the level state that
+/// changes during play, not a change since the previous packet, plus the pad and ball positions of the previous simulation step to interpolate between.
+/// Packets are plain data of a fixed size and never change after they are published, so the render thread reads them without locking.
+/// </summary>
+struct FramePacket {
+    /// <summary>
+    /// Index of the level being played.
+    /// </summary>
+    uint32_t levelIndex = 0;
+
+    /// <summary>
+    /// Fraction of the simulation step passed since the current positions were simulated, 0.0f draws the previous positions.
+    /// </summary>
+    float interpolation = 1.0f;
+
+    /// <summary>
+    /// Position of the pad before the last simulation step.
+    /// </summary>
+    glm::vec2 padPreviousPosition = {0.0f, 0.0f};
+
+    /// <summary>
+    /// Positions of the balls before the last simulation step.
+    /// </summary>
+    glm::vec2 ballPreviousPositions[MAX_BALL_COUNT] = {};
+
+    /// <summary>
+    /// State of the level after the last simulation step.
+    /// </summary>
+    LevelSnapshot level;
+};
+
+/// <summary>
+/// Lock-free triple buffer handing frame packets from the simulation thread to the render thread. The simulation thread writes a packet into a slot of its
+/// own and swaps it with the middle slot to publish it, the render thread swaps the middle slot with its own slot to take the latest packet. Neither
+/// thread ever waits for the other, packets the render thread does not get to in time are replaced by newer ones. The render thread may sleep until a
+/// packet is published, the wake up is only a hint and sleeping is bounded by a timeout, so publishing stays lock-free.
+/// </summary>
+class FramePacketBuffer {
+  public:
+    /// <summary>
+    /// Getter for the packet the simulation thread writes the next frame into.
+    /// </summary>
+    /// <returns>Packet owned by the simulation thread until it is published.</returns>
+    FramePacket& getWritePacket() { return m_packets[m_writeSlot]; }
+
+    /// <summary>
+    /// Publishes the packet written by the simulation thread, replacing the previously published packet if the render thread has not taken it yet.
+    /// </summary>
+    void publish() {
+        m_writeSlot = m_middleSlot.exchange(m_writeSlot | FRAME_PACKET_FRESH_BIT, std::memory_order_acq_rel) & FRAME_PACKET_SLOT_MASK;
+        m_packetPublished.notify_one();
+    }
+
+    /// <summary>
+    /// Takes the latest published packet for the render thread.
+    /// </summary>
+    /// <returns>Latest published packet, owned by the render thread until the next call, or nullptr if nothing was published since the last call.</returns>
+    const FramePacket* acquire() {
+        if (!(m_middleSlot.load(std::memory_order_relaxed) & FRAME_PACKET_FRESH_BIT)) {
+            return nullptr;
+        }
+
+        m_readSlot = m_middleSlot.exchange(m_readSlot, std::memory_order_acq_rel) & FRAME_PACKET_SLOT_MASK;
+        return &m_packets[m_readSlot];
+    }
+
+    /// <summary>
+    /// Puts the render thread to sleep until a packet is published or the timeout passes.
+    /// </summary>
+    /// <param name="timeout">Longest time to sleep in microseconds.</param>
+    void waitForPacket(const uint32_t& timeout) {
+        PROFILE_ZONE("FramePacketBuffer::waitForPacket");
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_packetPublished.wait_for(lock, std::chrono::microseconds(timeout),
+                                   [this]() { return (m_middleSlot.load(std::memory_order_relaxed) & FRAME_PACKET_FRESH_BIT) != 0; });
+    }
+
+  private:
+    /// <summary>
+    /// Slots of the triple buffer.
+    /// </summary>
+    FramePacket m_packets[3];
+
+    /// <summary>
+    /// Slot written by the simulation thread.
+    /// </summary>
+    uint32_t m_writeSlot = 0;
+
+    /// <summary>
+    /// Slot read by the render thread.
+    /// </summary>
+    uint32_t m_readSlot = 1;
+
+    /// <summary>
+    /// Slot holding the latest published packet, with FRAME_PACKET_FRESH_BIT set until the render thread takes it.
+    /// </summary>
+    std::atomic<uint32_t> m_middleSlot = 2;
+
+    /// <summary>
+    /// Only held by the render thread while it goes to sleep.
+    /// </summary>
+    std::mutex m_waitMutex;
+
+    /// <summary>
+    /// Wakes the render thread up when a packet is published.
+    /// </summary>
+    std::condition_variable m_packetPublished;
+};
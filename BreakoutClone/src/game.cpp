@@ -0,0 +1,271 @@
+#include "game.h"
+
+#include "physics.h"
+#include "profiler.h"
+#include "textureManager.h"
+
+#include "common.h"
+
+#include <algorithm>
+
+Game::Game(const std::vector<std::unique_ptr<Level>>& levels, const PhysicsMode& physicsMode)
+    : m_physics(std::make_unique<Physics>(physicsMode)), m_levels(levels) {
+    // One sound per collision event and the one for a lost life
+    m_sounds.reserve(COLLISION_EVENT_CAPACITY + 1);
+    // Switching levels never grows the ball directions, so restoring snapshots does not allocate
+    m_ballDirections.reserve(MAX_BALL_COUNT);
+}
+
+Game::~Game() {}
+
+void Game::initializeLevel(const uint32_t& lifeCount, const uint32_t& score, const uint32_t& levelIndex) {
+    m_score        = score;
+    m_lifeCount    = lifeCount;
+    m_currentLevel = m_levels[levelIndex].get();
+    m_currentLevel->load(m_lifeCount, m_score, levelIndex + 1);
+    m_ballDirections.resize(m_currentLevel->getBallCount());
+    m_currentLevel->setTitleVisibility(1.0f);
+    m_currentLevel->setTitle(TEXTURE_UI_LOADING_LEVEL);
+    m_stateTimeCounter  = 0;
+    m_currentLevelIndex = levelIndex;
+    m_gameState         = GameState::BEGIN_LEVEL;
+}
+
+void Game::tick(const uint32_t& tickTime, const GameInput& input) {
+    PROFILE_ZONE("Game::tick");
+
+    m_collisionEvents.clear();
+    m_sounds.clear();
+
+    switch (m_gameState) {
+        case GameState::BEGIN_LEVEL: {
+            if (m_stateTimeCounter < BEGIN_LEVEL_BEFORE_FADE + BEGIN_LEVEL_FADE) {
+                float alpha = fade(BEGIN_LEVEL_BEFORE_FADE, -BEGIN_LEVEL_FADE, m_stateTimeCounter);
+                m_currentLevel->setForegroundVisibility(alpha);
+                m_currentLevel->setTitleVisibility(alpha);
+            } else {
+                m_currentLevel->setSubtitle(TEXTURE_UI_RELEASE);
+                m_currentLevel->setSubtitleVisibility(1.0f);
+                m_gameState = GameState::BALL_ATTACHED;
+            }
+            break;
+        }
+        case GameState::BALL_ATTACHED: {
+            m_physics->resolveFrame(tickTime, *m_currentLevel, 0.0f, input.padControl, m_ballDirections, m_collisionEvents);
+            if (input.release) {
+                for (uint32_t i = 0; i < m_currentLevel->getBallCount(); ++i) {
+                    m_ballDirections[i] = m_currentLevel->getStartingBallDirection(i);
+                }
+                m_currentLevel->setSubtitleVisibility(0.0f);
+                m_gameState = GameState::PLAYING;
+            }
+            break;
+        }
+        case GameState::PLAYING: {
+            switch (m_physics->resolveFrame(tickTime, *m_currentLevel, 1.0f, input.padControl, m_ballDirections, m_collisionEvents)) {
+                case LevelState::STILL_ALIVE: {
+                    Instance* const bricks = m_currentLevel->getBricksPtr();
+                    for (uint32_t i = 0; i < m_collisionEvents.getCount(); ++i) {
+                        const CollisionData& collisionData = m_collisionEvents[i];
+                        switch (collisionData.type) {
+                            case CollisionType::WALL: {
+                                queueSound(m_currentLevel->getWallSound());
+                                break;
+                            }
+                            case CollisionType::PAD: {
+                                queueSound(m_currentLevel->getPadSound());
+                                break;
+                            }
+                            case CollisionType::BRICK: {
+                                const Instance& brick = bricks[collisionData.hitBrickIndex];
+                                // The ball can hit the same brick more than once in a frame, it may already be destroyed
+                                if (brick.health == 0) {
+                                    break;
+                                }
+
+                                const BrickType& brickType = m_currentLevel->getBrickData(collisionData.brickTypeId);
+                                if (brick.maxHealth < UINT32_MAX) {
+                                    if (m_currentLevel->damageBrick(collisionData.hitBrickIndex) == 0) {
+                                        m_score += brickType.breakScore;
+                                        m_currentLevel->setScore(m_score);
+                                        m_currentLevel->destroyBrick(collisionData.hitBrickIndex);
+                                        queueSound(brickType.breakSound);
+                                    } else {
+                                        queueSound(brickType.hitSound);
+                                    }
+                                } else {
+                                    queueSound(brickType.hitSound);
+                                }
+                                break;
+                            }
+                            default:
+                                break;
+                        }
+                    }
+
+                    if (m_currentLevel->getRemainingBrickCount() == 0) {
+                        if (m_currentLevelIndex == m_levels.size() - 1) {
+                            m_currentLevel->setTitle(TEXTURE_UI_VICTORY);
+                        } else {
+                            m_currentLevel->setTitle(TEXTURE_UI_LEVEL_COMPLETE);
+                        }
+
+                        m_gameState        = GameState::WIN_LEVEL;
+                        m_stateTimeCounter = 0;
+                    }
+                    break;
+                }
+                case LevelState::LOST: {
+                    queueSound(m_currentLevel->getLostLifeSound());
+                    --m_lifeCount;
+                    m_currentLevel->setLifeCount(m_lifeCount);
+                    if (m_lifeCount == 0) {
+                        m_stateTimeCounter = 0;
+                        m_currentLevel->setTitle(TEXTURE_UI_GAME_OVER);
+                        m_gameState = GameState::LOSE_GAME;
+                    } else {
+                        m_currentLevel->resetPadAndBall();
+                        m_currentLevel->setSubtitle(TEXTURE_UI_RELEASE);
+                        m_currentLevel->setSubtitleVisibility(1.0f);
+                        m_gameState = GameState::BALL_ATTACHED;
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        case GameState::LOSE_GAME: {
+            if (m_stateTimeCounter < LOSE_GAME_FADE) {
+                float alpha = fade(0, LOSE_GAME_FADE, m_stateTimeCounter);
+                m_currentLevel->setForegroundVisibility(alpha);
+                m_currentLevel->setTitleVisibility(alpha);
+            } else {
+                m_currentLevel->setSubtitle(TEXTURE_UI_TRY);
+                m_currentLevel->setSubtitleVisibility(1.0f);
+                m_gameState = GameState::RESTART_SCREEN;
+            }
+            break;
+        }
+        case GameState::RESTART_SCREEN: {
+            if (input.release) {
+                initializeLevel(START_LIFE_COUNT, 0, 0);
+                m_stateTimeCounter = 0;
+                m_currentLevel->setSubtitleVisibility(0.0f);
+                m_currentLevel->resetPadAndBall();
+            } else if (input.quit) {
+                m_quitRequested = true;
+            }
+            break;
+        }
+
+        case GameState::WIN_LEVEL: {
+            if (m_stateTimeCounter < LEVEL_WIN_FADE) {
+                float alpha = fade(0, LEVEL_WIN_FADE, m_stateTimeCounter);
+                m_currentLevel->setForegroundVisibility(alpha);
+                m_currentLevel->setTitleVisibility(alpha);
+            } else {
+                if (m_currentLevelIndex < m_levels.size() - 1) {
+                    initializeLevel(m_lifeCount, m_score, m_currentLevelIndex + 1);
+                } else {
+                    m_currentLevel->setSubtitle(TEXTURE_UI_TRY);
+                    m_currentLevel->setSubtitleVisibility(1.0f);
+                    m_gameState = GameState::WIN_GAME;
+                }
+            }
+            break;
+        }
+        case GameState::WIN_GAME: {
+            if (input.release) {
+                initializeLevel(START_LIFE_COUNT, 0, 0);
+                m_stateTimeCounter = 0;
+
+                m_gameState = GameState::BEGIN_LEVEL;
+            } else if (input.quit) {
+                m_quitRequested = true;
+            }
+            break;
+        }
+    }
+
+    // A dropped brick event would leave a brick the ball bounced off undamaged
+    assert(m_collisionEvents.getDroppedCount() == 0);
+
+    m_stateTimeCounter += tickTime;
+}
+
+void Game::captureSnapshot(GameSnapshot& snapshot) const {
+    snapshot.levelIndex       = m_currentLevelIndex;
+    snapshot.gameState        = m_gameState;
+    snapshot.stateTimeCounter = m_stateTimeCounter;
+    snapshot.lifeCount        = m_lifeCount;
+    snapshot.score            = m_score;
+    snapshot.quitRequested    = m_quitRequested;
+    std::copy(m_ballDirections.begin(), m_ballDirections.end(), snapshot.ballDirections);
+    m_currentLevel->captureSnapshot(snapshot.level);
+}
+
+void Game::restoreSnapshot(const GameSnapshot& snapshot) {
+    if (m_currentLevel == nullptr || m_currentLevelIndex != snapshot.levelIndex) {
+        m_currentLevel      = m_levels[snapshot.levelIndex].get();
+        m_currentLevelIndex = snapshot.levelIndex;
+        m_currentLevel->load(snapshot.lifeCount, snapshot.score, snapshot.levelIndex + 1);
+        m_ballDirections.resize(m_currentLevel->getBallCount());
+    }
+
+    m_gameState        = snapshot.gameState;
+    m_stateTimeCounter = snapshot.stateTimeCounter;
+    m_lifeCount        = snapshot.lifeCount;
+    m_score            = snapshot.score;
+    m_quitRequested    = snapshot.quitRequested;
+    std::copy(snapshot.ballDirections, snapshot.ballDirections + m_ballDirections.size(), m_ballDirections.begin());
+    m_currentLevel->restoreSnapshot(snapshot.level);
+
+    m_collisionEvents.clear();
+    m_sounds.clear();
+}
+
+const uint64_t Game::getStateHash() const {
+    uint64_t hash = hashCombine(m_currentLevel->getStateHash(m_physics->getMode() == PhysicsMode::FIXED_POINT),
+                                packPair(m_currentLevelIndex, static_cast<uint32_t>(m_gameState)));
+    hash          = hashCombine(hash, packPair(m_lifeCount, m_score));
+    hash          = hashCombine(hash, m_stateTimeCounter);
+    for (const glm::vec2& ballDirection : m_ballDirections) {
+        hash = hashCombine(hash, packPair(floatBits(ballDirection.x), floatBits(ballDirection.y)));
+    }
+    return hash;
+}
+
+const float Game::predictBallLanding(const uint32_t& ball) const { return m_physics->predictBallLanding(*m_currentLevel, ball, m_ballDirections[ball]); }
+
+const GameState& Game::getGameState() const { return m_gameState; }
+
+Level* const Game::getCurrentLevel() const { return m_currentLevel; }
+
+const uint32_t& Game::getCurrentLevelIndex() const { return m_currentLevelIndex; }
+
+const uint32_t& Game::getScore() const { return m_score; }
+
+const uint32_t& Game::getLifeCount() const { return m_lifeCount; }
+
+const std::vector<glm::vec2>& Game::getBallDirections() const { return m_ballDirections; }
+
+const CollisionEventRing& Game::getCollisionEvents() const { return m_collisionEvents; }
+
+const SubStepStatistics& Game::getSubStepStatistics() const { return m_physics->getSubStepStatistics(); }
+
+void Game::resetSubStepStatistics() { m_physics->resetSubStepStatistics(); }
+
+const std::vector<uint32_t>& Game::getSounds() const { return m_sounds; }
+
+const bool& Game::isQuitRequested() const { return m_quitRequested; }
+
+const float Game::fade(const int32_t& holdBefore, const int32_t& fadeTime, const uint32_t& currentStateTime) {
+    float value = static_cast<int32_t>(currentStateTime - holdBefore) / static_cast<float>(fadeTime) + (fadeTime > 0 ? 0.0f : 1.0f);
+    return std::clamp(value, 0.0f, 1.0f);
+}
+
+void Game::queueSound(const uint32_t& soundHandle) {
+    if (soundHandle != NO_SOUND) {
+        m_sounds.push_back(soundHandle);
+    }
+}
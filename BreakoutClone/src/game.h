@@ -0,0 +1,288 @@
+#pragma once
+#include "level.h"
+#include "physics.h"
+
+#include <memory>
+#include <type_traits>
+
+// In simulation steps per second, independent of the framerate
+#define PHYSICS_TICK_RATE 120
+
+#define START_LIFE_COUNT 5
+
+#define BEGIN_LEVEL_BEFORE_FADE SECONDS_TO_MICROSECONDS(1)
+#define BEGIN_LEVEL_FADE        SECONDS_TO_MICROSECONDS(2)
+#define LOSE_GAME_FADE          SECONDS_TO_MICROSECONDS(3)
+#define LEVEL_WIN_FADE          SECONDS_TO_MICROSECONDS(3)
+
+/// <summary>
+/// States that the game can be in.
+/// </summary>
+enum class GameState { BEGIN_LEVEL, BALL_ATTACHED, PLAYING, LOSE_LIFE, LOSE_GAME, RESTART_SCREEN, WIN_LEVEL, WIN_GAME };
+
+/// <summary>
+/// Player input for a single simulation step.
+/// </summary>
+struct GameInput {
+    /// <summary>
+    /// X-axis speed of the pad, -1.0f moving it left and 1.0f moving it right at full speed.
+    /// </summary>
+    float padControl = 0.0f;
+
+    /// <summary>
+    /// Releases the ball from the pad, or starts a new game on the end screens.
+    /// </summary>
+    bool release = false;
+
+    /// <summary>
+    /// Quits the game on the end screens.
+    /// </summary>
+    bool quit = false;
+};
+
+/// <summary>
+/// Plain data copy of the whole simulation state of a game, the game rules as well as the level being played. Taking and restoring a snapshot only copies
+/// the state that changes during play, so it can be done every simulation step, for rollback, quick restarts or searching ahead.
+/// </summary>
+struct GameSnapshot {
+    /// <summary>
+    /// Index of the level being played.
+    /// </summary>
+    uint32_t levelIndex = 0;
+
+    /// <summary>
+    /// Game state.
+    /// </summary>
+    GameState gameState = GameState::BEGIN_LEVEL;
+
+    /// <summary>
+    /// Time spent in the game state.
+    /// </summary>
+    uint32_t stateTimeCounter = 0;
+
+    /// <summary>
+    /// Remaining player lives.
+    /// </summary>
+    uint32_t lifeCount = 0;
+
+    /// <summary>
+    /// Player score.
+    /// </summary>
+    uint32_t score = 0;
+
+    /// <summary>
+    /// Boolean set when the player asked to quit the game.
+    /// </summary>
+    bool quitRequested = false;
+
+    /// <summary>
+    /// Directions of the balls.
+    /// </summary>
+    glm::vec2 ballDirections[MAX_BALL_COUNT] = {};
+
+    /// <summary>
+    /// State of the level being played.
+    /// </summary>
+    LevelSnapshot level;
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "Game snapshots must be plain data, so they can be copied around freely.");
+
+/// <summary>
+/// Runs the rules of the game on a set of levels, one simulation step at a time. Knows nothing about windows, rendering or sound, so it can be driven
+/// by the game loop as well as by headless tools.
+/// </summary>
+class Game {
+  public:
+    /// <summary>
+    /// Creates the game and the physics resolver.
+    /// </summary>
+    /// <param name="levels">Levels to be played, in order. They have to outlive the game.</param>
+    /// <param name="physicsMode">Number representation used by the physics calculations.</param>
+    Game(const std::vector<std::unique_ptr<Level>>& levels, const PhysicsMode& physicsMode = PhysicsMode::FLOATING_POINT);
+    ~Game();
+
+    /// <summary>
+    /// Sets up a level, making it start on the next simulation step.
+    /// </summary>
+    /// <param name="lifeCount">Amount of lives to be initially shown on screen.</param>
+    /// <param name="score">Score to be initially shown on screen.</param>
+    /// <param name="levelIndex">Index of the level in the level vector.</param>
+    void initializeLevel(const uint32_t& lifeCount, const uint32_t& score, const uint32_t& levelIndex);
+
+    /// <summary>
+    /// Runs a single simulation step worth of game logic. Collision data and sounds of the previous step are discarded.
+    /// </summary>
+    /// <param name="tickTime">Duration of the simulation step.</param>
+    /// <param name="input">Player input for the step.</param>
+    void tick(const uint32_t& tickTime, const GameInput& input);
+
+    /// <summary>
+    /// Copies the whole simulation state into the snapshot, without allocating.
+    /// </summary>
+    /// <param name="snapshot">Snapshot to be filled.</param>
+    void captureSnapshot(GameSnapshot& snapshot) const;
+
+    /// <summary>
+    /// Puts the game back into the state of the snapshot. Restoring a snapshot of the level being played does not allocate, a snapshot of another level
+    /// loads that level first. Collision events and sounds of the last simulation step are discarded.
+    /// </summary>
+    /// <param name="snapshot">Snapshot taken from a game on the same levels.</param>
+    void restoreSnapshot(const GameSnapshot& snapshot);
+
+    /// <summary>
+    /// Hashes the whole simulation state, the level state as well as the game state, score, lives and ball directions. Cheap enough to be logged every
+    /// simulation step, two runs diverge at the first step their hashes differ.
+    /// </summary>
+    /// <returns>Hash of the simulation state.</returns>
+    const uint64_t getStateHash() const;
+
+    /// <summary>
+    /// Predicts where a ball of the current level reaches the height of the pad top if it only bounces off the walls on the way.
+    /// </summary>
+    /// <param name="ball">Index of the ball, relative to the first ball.</param>
+    /// <returns>X coordinate of the ball center when it reaches the height of the pad top.</returns>
+    const float predictBallLanding(const uint32_t& ball) const;
+
+    /// <summary>
+    /// Getter for the current game state.
+    /// </summary>
+    /// <returns>The current game state.</returns>
+    const GameState& getGameState() const;
+
+    /// <summary>
+    /// Getter for the currently active level.
+    /// </summary>
+    /// <returns>Pointer to the currently active level.</returns>
+    Level* const getCurrentLevel() const;
+
+    /// <summary>
+    /// Getter for the index of the currently active level.
+    /// </summary>
+    /// <returns>Index of the currently active level.</returns>
+    const uint32_t& getCurrentLevelIndex() const;
+
+    /// <summary>
+    /// Getter for the current player score.
+    /// </summary>
+    /// <returns>The current player score.</returns>
+    const uint32_t& getScore() const;
+
+    /// <summary>
+    /// Getter for the remaining player lives.
+    /// </summary>
+    /// <returns>The remaining player lives.</returns>
+    const uint32_t& getLifeCount() const;
+
+    /// <summary>
+    /// Getter for the directions of the balls of the current level.
+    /// </summary>
+    /// <returns>Vector of the directions of the balls, normalized, one for each ball of the level.</returns>
+    const std::vector<glm::vec2>& getBallDirections() const;
+
+    /// <summary>
+    /// Getter for the collisions resolved in the last simulation step.
+    /// </summary>
+    /// <returns>Ring of the collision events of the last simulation step.</returns>
+    const CollisionEventRing& getCollisionEvents() const;
+
+    /// <summary>
+    /// Getter for the sub-step counters of the physics.
+    /// </summary>
+    /// <returns>Sub-step counters accumulated since the game was created or the counters were last reset.</returns>
+    const SubStepStatistics& getSubStepStatistics() const;
+
+    /// <summary>
+    /// Sets all sub-step counters of the physics to zero.
+    /// </summary>
+    void resetSubStepStatistics();
+
+    /// <summary>
+    /// Getter for the sounds triggered in the last simulation step.
+    /// </summary>
+    /// <returns>Vector of handles of the sounds, as resolved by the level.</returns>
+    const std::vector<uint32_t>& getSounds() const;
+
+    /// <summary>
+    /// Checks whether the player asked to quit the game.
+    /// </summary>
+    /// <returns>True if the player asked to quit the game, false otherwise.</returns>
+    const bool& isQuitRequested() const;
+
+  private:
+    /// <summary>
+    /// Physics resolver of the game.
+    /// </summary>
+    std::unique_ptr<Physics> m_physics;
+
+    /// <summary>
+    /// Vector of all the levels of the game.
+    /// </summary>
+    const std::vector<std::unique_ptr<Level>>& m_levels;
+
+    /// <summary>
+    /// Timer for fade in and fade out operations at the start of various game states.
+    /// </summary>
+    uint32_t m_stateTimeCounter = 0;
+
+    /// <summary>
+    /// Current directions of the balls, normalized.
+    /// </summary>
+    std::vector<glm::vec2> m_ballDirections;
+
+    /// <summary>
+    /// Remaining player lives.
+    /// </summary>
+    uint32_t m_lifeCount = START_LIFE_COUNT;
+
+    /// <summary>
+    /// Current player score
+    /// </summary>
+    uint32_t m_score = 0;
+
+    /// <summary>
+    /// Current game state.
+    /// </summary>
+    GameState m_gameState = GameState::BEGIN_LEVEL;
+
+    /// <summary>
+    /// Pointer to currently active level.
+    /// </summary>
+    Level* m_currentLevel = nullptr;
+
+    /// <summary>
+    /// Index of the currently active level.
+    /// </summary>
+    uint32_t m_currentLevelIndex = 0;
+
+    /// <summary>
+    /// Ring of collision events of the current simulation step.
+    /// </summary>
+    CollisionEventRing m_collisionEvents;
+
+    /// <summary>
+    /// Vector of handles of the sounds triggered in the current simulation step. Has room for a sound per collision event, so it never grows after the
+    /// game is created.
+    /// </summary>
+    std::vector<uint32_t> m_sounds = {};
+
+    /// <summary>
+    /// Boolean set when the player asks to quit the game.
+    /// </summary>
+    bool m_quitRequested = false;
+
+    /// <summary>
+    /// Calculates an alpha value based on time and parameters given.
+    /// </summary>
+    /// <param name="holdBefore">Amount of time to keep alpha clamped to initial value (0.0f or 1.0f, see fadeTime param) before fading in or out.</param>
+    /// <param name="fadeTime">Time it takes to fade from visible to black. Negative value fades from black to visible.</param>
+    /// <param name="currentStateTime">Timestamp from the start for which alpha value is to be calculated.</param>
+    /// <returns>Alpha value for fade at the input timestamp.</returns>
+    const float fade(const int32_t& holdBefore, const int32_t& fadeTime, const uint32_t& currentStateTime);
+
+    /// <summary>
+    /// Adds the sound to the sounds triggered in the current simulation step.
+    /// </summary>
+    /// <param name="soundHandle">Handle of the sound, NO_SOUND is skipped.</param>
+    void queueSound(const uint32_t& soundHandle);
+};
@@ -0,0 +1,158 @@
+#include "inputLog.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// Magic, version, tick time, physics mode, level count and run count
+#define INPUT_LOG_HEADER_SIZE 24
+
+// Tick count, pad control and the buttons
+#define INPUT_LOG_RUN_SIZE 9
+
+#define INPUT_LOG_RELEASE_BIT 0x1
+#define INPUT_LOG_QUIT_BIT    0x2
+
+/// <summary>
+/// Appends a 32 bit value to the buffer, least significant byte first.
+/// </summary>
+/// <param name="buffer">Buffer to be appended to.</param>
+/// <param name="value">Value to be appended.</param>
+static void writeUint32(std::vector<uint8_t>& buffer, const uint32_t& value) {
+    for (uint32_t i = 0; i < 4; ++i) {
+        buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+/// <summary>
+/// Reads a 32 bit value stored least significant byte first.
+/// </summary>
+/// <param name="bytes">Pointer to the first byte of the value.</param>
+/// <returns>The value read.</returns>
+static uint32_t readUint32(const uint8_t* bytes) {
+    return bytes[0] | static_cast<uint32_t>(bytes[1]) << 8 | static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+InputLog::InputLog(const uint32_t& tickTime, const PhysicsMode& physicsMode, const uint32_t& levelCount)
+    : m_tickTime(tickTime), m_physicsMode(physicsMode), m_levelCount(levelCount) {}
+
+InputLog::InputLog(const char* path) {
+    std::ifstream        file(path, std::ios::binary);
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!file.is_open() || buffer.size() < INPUT_LOG_HEADER_SIZE || readUint32(&buffer[0]) != INPUT_LOG_MAGIC) {
+        char error[512];
+        snprintf(error, sizeof(error), "Failed to read input log at location %s!", path);
+        throw std::runtime_error(error);
+    }
+
+    const uint32_t version = readUint32(&buffer[4]);
+    if (version != INPUT_LOG_VERSION) {
+        char error[512];
+        snprintf(error, sizeof(error), "Input log at location %s is of version %u, only version %d is supported!", path, version, INPUT_LOG_VERSION);
+        throw std::runtime_error(error);
+    }
+
+    const uint32_t runCount = readUint32(&buffer[20]);
+    if (buffer.size() != INPUT_LOG_HEADER_SIZE + static_cast<uint64_t>(runCount) * INPUT_LOG_RUN_SIZE) {
+        char error[512];
+        snprintf(error, sizeof(error), "Input log at location %s is corrupted!", path);
+        throw std::runtime_error(error);
+    }
+
+    m_tickTime    = readUint32(&buffer[8]);
+    m_physicsMode = readUint32(&buffer[12]) ? PhysicsMode::FIXED_POINT : PhysicsMode::FLOATING_POINT;
+    m_levelCount  = readUint32(&buffer[16]);
+
+    m_runs.resize(runCount);
+    const uint8_t* runBytes = &buffer[INPUT_LOG_HEADER_SIZE];
+    for (InputRun& run : m_runs) {
+        const uint32_t padControlBits = readUint32(runBytes + 4);
+        run.tickCount                 = readUint32(runBytes);
+        run.input.release             = (runBytes[8] & INPUT_LOG_RELEASE_BIT) != 0;
+        run.input.quit                = (runBytes[8] & INPUT_LOG_QUIT_BIT) != 0;
+        memcpy(&run.input.padControl, &padControlBits, sizeof(float));
+
+        if (run.tickCount == 0) {
+            char error[512];
+            snprintf(error, sizeof(error), "Input log at location %s is corrupted!", path);
+            throw std::runtime_error(error);
+        }
+
+        m_tickCount += run.tickCount;
+        runBytes += INPUT_LOG_RUN_SIZE;
+    }
+}
+
+void InputLog::record(const GameInput& input) {
+    // Pad control is compared bit for bit, the log has to reproduce the exact input
+    if (!m_runs.empty()) {
+        const GameInput& last = m_runs.back().input;
+        if (!memcmp(&last.padControl, &input.padControl, sizeof(float)) && last.release == input.release && last.quit == input.quit &&
+            m_runs.back().tickCount < UINT32_MAX) {
+            ++m_runs.back().tickCount;
+            ++m_tickCount;
+            return;
+        }
+    }
+
+    InputRun run;
+    run.tickCount = 1;
+    run.input     = input;
+    m_runs.push_back(run);
+    ++m_tickCount;
+}
+
+void InputLog::save(const char* path) const {
+    std::vector<uint8_t> buffer;
+    buffer.reserve(INPUT_LOG_HEADER_SIZE + m_runs.size() * INPUT_LOG_RUN_SIZE);
+    writeUint32(buffer, INPUT_LOG_MAGIC);
+    writeUint32(buffer, INPUT_LOG_VERSION);
+    writeUint32(buffer, m_tickTime);
+    writeUint32(buffer, m_physicsMode == PhysicsMode::FIXED_POINT ? 1 : 0);
+    writeUint32(buffer, m_levelCount);
+    writeUint32(buffer, static_cast<uint32_t>(m_runs.size()));
+
+    for (const InputRun& run : m_runs) {
+        uint32_t padControlBits;
+        memcpy(&padControlBits, &run.input.padControl, sizeof(float));
+        writeUint32(buffer, run.tickCount);
+        writeUint32(buffer, padControlBits);
+        buffer.push_back(static_cast<uint8_t>((run.input.release ? INPUT_LOG_RELEASE_BIT : 0) | (run.input.quit ? INPUT_LOG_QUIT_BIT : 0)));
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    if (!file) {
+        char error[512];
+        snprintf(error, sizeof(error), "Failed to write input log at location %s!", path);
+        throw std::runtime_error(error);
+    }
+}
+
+bool InputLog::next(GameInput& input) {
+    if (m_playbackRun == m_runs.size()) {
+        return false;
+    }
+
+    input = m_runs[m_playbackRun].input;
+    if (++m_playbackTick == m_runs[m_playbackRun].tickCount) {
+        ++m_playbackRun;
+        m_playbackTick = 0;
+    }
+    return true;
+}
+
+void InputLog::rewind() {
+    m_playbackRun  = 0;
+    m_playbackTick = 0;
+}
+
+const uint32_t& InputLog::getTickTime() const { return m_tickTime; }
+
+const PhysicsMode& InputLog::getPhysicsMode() const { return m_physicsMode; }
+
+const uint32_t& InputLog::getLevelCount() const { return m_levelCount; }
+
+const uint64_t& InputLog::getTickCount() const { return m_tickCount; }
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "game.h"
+
+#include "common.h"
+
+#include <vector>
+
+// Marks the start of an input log file, "BKIL" read as a little endian integer
+#define INPUT_LOG_MAGIC 0x4C494B42
+
+// Bumped whenever the layout of the input log file changes
+#define INPUT_LOG_VERSION 1
+
+/// <summary>
+/// Player input of every simulation step of a game, started on the first level, kept as runs of steps with the same input. A player holds the same keys for
+/// many steps in a row, so a whole session takes a few kilobytes. Logs are saved as little endian binary files and can be fed back to a game, which plays
+/// exactly like the recorded one as long as it runs the same levels with the same physics mode on the same build.
+/// </summary>
+class InputLog {
+  public:
+    /// <summary>
+    /// Creates an empty log to record into.
+    /// </summary>
+    /// <param name="tickTime">Duration of the simulation steps.</param>
+    /// <param name="physicsMode">Number representation used by the physics calculations of the recorded game.</param>
+    /// <param name="levelCount">Number of levels of the recorded game.</param>
+    InputLog(const uint32_t& tickTime, const PhysicsMode& physicsMode, const uint32_t& levelCount);
+
+    /// <summary>
+    /// Loads a log saved to a file, ready to be played back from the first step.
+    /// </summary>
+    /// <param name="path">Path to the log file.</param>
+    InputLog(const char* path);
+
+    /// <summary>
+    /// Appends the input of a simulation step to the log.
+    /// </summary>
+    /// <param name="input">Input of the simulation step.</param>
+    void record(const GameInput& input);
+
+    /// <summary>
+    /// Saves the log to a file.
+    /// </summary>
+    /// <param name="path">Path to the log file, an existing file is overwritten.</param>
+    void save(const char* path) const;
+
+    /// <summary>
+    /// Reads the input of the next simulation step.
+    /// </summary>
+    /// <param name="input">Input of the next simulation step, unchanged once the log is played to the end.</param>
+    /// <returns>True if there was a step left, false once the log is played to the end.</returns>
+    bool next(GameInput& input);
+
+    /// <summary>
+    /// Makes playback start over from the first simulation step.
+    /// </summary>
+    void rewind();
+
+    /// <summary>
+    /// Getter for the duration of the simulation steps.
+    /// </summary>
+    /// <returns>Duration of the simulation steps in microseconds.</returns>
+    const uint32_t& getTickTime() const;
+
+    /// <summary>
+    /// Getter for the physics mode of the recorded game.
+    /// </summary>
+    /// <returns>Number representation used by the physics calculations of the recorded game.</returns>
+    const PhysicsMode& getPhysicsMode() const;
+
+    /// <summary>
+    /// Getter for the number of levels of the recorded game.
+    /// </summary>
+    /// <returns>Number of levels of the recorded game.</returns>
+    const uint32_t& getLevelCount() const;
+
+    /// <summary>
+    /// Getter for the number of recorded simulation steps.
+    /// </summary>
+    /// <returns>Number of recorded simulation steps.</returns>
+    const uint64_t& getTickCount() const;
+
+  private:
+    /// <summary>
+    /// Input held for a number of consecutive simulation steps.
+    /// </summary>
+    struct InputRun {
+        /// <summary>
+        /// Number of simulation steps the input is held for.
+        /// </summary>
+        uint32_t tickCount = 0;
+
+        /// <summary>
+        /// Input of the simulation steps.
+        /// </summary>
+        GameInput input = {};
+    };
+
+    /// <summary>
+    /// Duration of the simulation steps in microseconds.
+    /// </summary>
+    uint32_t m_tickTime = 0;
+
+    /// <summary>
+    /// Number representation used by the physics calculations of the recorded game.
+    /// </summary>
+    PhysicsMode m_physicsMode = PhysicsMode::FLOATING_POINT;
+
+    /// <summary>
+    /// Number of levels of the recorded game.
+    /// </summary>
+    uint32_t m_levelCount = 0;
+
+    /// <summary>
+    /// Number of recorded simulation steps.
+    /// </summary>
+    uint64_t m_tickCount = 0;
+
+    /// <summary>
+    /// Recorded input, in the order of the simulation steps.
+    /// </summary>
+    std::vector<InputRun> m_runs;
+
+    /// <summary>
+    /// Index of the run holding the next simulation step to be played back.
+    /// </summary>
+    uint32_t m_playbackRun = 0;
+
+    /// <summary>
+    /// Number of simulation steps of the current run already played back.
+    /// </summary>
+    uint32_t m_playbackTick = 0;
+};
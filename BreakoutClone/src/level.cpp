@@ -1,6 +1,12 @@
 #include "level.h"
 
+#include "framePacket.h"
+#include "profiler.h"
+
+#ifndef BREAKOUT_HEADLESS
 #include "renderer.h"
+#include "soundManager.h"
+#endif
 #include "textureManager.h"
 
 // This generally silences all warnings in the external file, but it doesn't work for warning bellow.
@@ -26,81 +32,405 @@
 #include "common.h"
 
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 
-Level::Level(const char* levelPath, const uint32_t& windowWidth, const uint32_t& windowHeight, Renderer* const renderer, TextureManager* const textureManager)
-    : m_windowWidth(windowWidth), m_windowHeight(windowHeight), m_renderer(renderer), m_textureManager(textureManager) {
+/// <summary>
+/// Hashes the health of a single brick, the hash of all the bricks being the exclusive or of these.
+/// </summary>
+/// <param name="brickIndex">Index of the brick, relative to the first brick.</param>
+/// <param name="health">Health of the brick.</param>
+/// <returns>Hash of the brick health.</returns>
+static uint64_t hashBrickHealth(const uint32_t& brickIndex, const uint32_t& health) { return hashCombine(brickIndex, health); }
+
+Level::Level(const char* levelPath, const uint32_t& windowWidth, const uint32_t& windowHeight, Renderer* const renderer, TextureManager* const textureManager,
+             SoundManager* const soundManager)
+    : m_windowWidth(windowWidth), m_windowHeight(windowHeight), m_renderer(renderer), m_textureManager(textureManager), m_soundManager(soundManager) {
 
     parseXml(levelPath);
     generateRenderData();
+
+    m_padSound      = getSoundHandle(SOUND_PAD);
+    m_wallSound     = getSoundHandle(SOUND_WALL);
+    m_lostLifeSound = getSoundHandle(SOUND_WILHELM);
 }
 
-Level::~Level() { m_renderer->waitIdle(); }
+Level::~Level() {
+#ifndef BREAKOUT_HEADLESS
+    m_renderer->waitIdle();
+#endif
+}
 
 void Level::load(const uint32_t& lifeCount, const uint32_t& score, const uint32_t& levelIndex) {
     m_inUse = m_backup;
+    storePreviousPositions();
 
-    m_renderer->uploadToHostVisibleBuffer(m_inUse.instances.data(), m_instanceDataBufferSize, m_instanceBuffer->memory);
-    m_renderer->updateTextureArray(m_textureManager->getTextureArray());
-    m_renderer->recordRenderCommandBuffers(m_instanceBuffer->buffer, static_cast<uint32_t>(m_inUse.instances.size()));
-
-    setNumber(m_levelCountStartIndex, LEVEL_COUNT_DIGITS, levelIndex);
+    setNumber(m_inUse.instances, m_levelCountStartIndex, LEVEL_COUNT_DIGITS, levelIndex);
     setLifeCount(lifeCount);
     setScore(score);
 }
 
-void Level::updateGPUData() const { m_renderer->uploadToHostVisibleBuffer(m_inUse.instances.data(), m_instanceDataBufferSize, m_instanceBuffer->memory); }
+void Level::captureFramePacket(FramePacket& packet) const {
+    PROFILE_ZONE("Level::captureFramePacket");
+
+    captureSnapshot(packet.level);
+    packet.padPreviousPosition = m_padPreviousPosition;
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        packet.ballPreviousPositions[i] = m_ballPreviousPositions[i];
+    }
+}
+
+void Level::bindRenderData([[maybe_unused]] const uint32_t& levelNumber) {
+    PROFILE_ZONE("Level::bindRenderData");
+
+#ifndef BREAKOUT_HEADLESS
+    m_renderInstances = m_backup.instances;
+    setNumber(m_renderInstances, m_levelCountStartIndex, LEVEL_COUNT_DIGITS, levelNumber);
+
+    m_renderer->uploadToHostVisibleBuffer(m_renderInstances.data(), m_instanceDataBufferSize, m_instanceBuffer->memory);
+    m_renderer->updateTextureArray(m_textureManager->getTextureArray());
+    m_renderer->recordRenderCommandBuffers(m_instanceBuffer->buffer, static_cast<uint32_t>(m_renderInstances.size()));
+#endif
+}
+
+void Level::updateGPUData([[maybe_unused]] const FramePacket& packet) {
+    PROFILE_ZONE("Level::updateGPUData");
+
+#ifndef BREAKOUT_HEADLESS
+    const LevelSnapshot&   snapshot      = packet.level;
+    const float&           interpolation = packet.interpolation;
+    std::vector<Instance>& instances     = m_renderInstances;
+
+    instances[PAD_INDEX].position = packet.padPreviousPosition + (snapshot.padPosition - packet.padPreviousPosition) * interpolation;
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        Instance& ball = instances[m_ballIndex + i];
+        ball.position  = packet.ballPreviousPositions[i] + (snapshot.ballPositions[i] - packet.ballPreviousPositions[i]) * interpolation;
+        ball.health    = snapshot.ballHealth[i];
+    }
+
+    for (uint32_t i = 0; i < m_totalBrickCount; ++i) {
+        instances[BRICK_START_INDEX + i].health = snapshot.brickHealth[i];
+    }
+
+    // Bricks of moving rows are only placed for drawing, physics shifts the whole row by its offset instead
+    const BrickColliders& colliders = m_backup.brickColliders;
+    for (uint64_t rows = colliders.movingRows & snapshot.aliveRows; rows != 0; rows &= rows - 1) {
+        uint32_t row   = countTrailingZeros(rows);
+        float    shift = toFloat(snapshot.rowOffsets[row]) + toFloat(snapshot.rowDisplacements[row]) * interpolation;
+        for (uint32_t brick = row * m_columnCount; brick < (row + 1) * m_columnCount; ++brick) {
+            instances[BRICK_START_INDEX + brick].position.x = colliders.x[brick] + shift;
+        }
+    }
+
+    instances[m_foregroundIndex].textureAlpha = snapshot.foregroundAlpha;
+    instances[m_titleIndex].textureIndex      = snapshot.titleTexture;
+    instances[m_titleIndex].textureAlpha      = snapshot.titleAlpha;
+    instances[m_subtitleIndex].textureIndex   = snapshot.subtitleTexture;
+    instances[m_subtitleIndex].textureAlpha   = snapshot.subtitleAlpha;
+    for (uint32_t i = 0; i < LIFE_COUNT_DIGITS; ++i) {
+        instances[m_livesCountStartIndex + i].textureIndex = snapshot.lifeDigitTextures[i];
+    }
+    for (uint32_t i = 0; i < SCORE_COUNT_DIGITS; ++i) {
+        instances[m_scoreCountStartIndex + i].textureIndex = snapshot.scoreDigitTextures[i];
+    }
+
+    m_renderer->uploadToHostVisibleBuffer(instances.data(), m_instanceDataBufferSize, m_instanceBuffer->memory);
+#endif
+}
+
+void Level::storePreviousPositions() {
+    m_padPreviousPosition = m_inUse.instances[PAD_INDEX].position;
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        m_ballPreviousPositions[i] = m_inUse.instances[m_ballIndex + i].position;
+    }
+}
 
 void Level::setForegroundVisibility(const float& alpha) { m_inUse.instances[m_foregroundIndex].textureAlpha = alpha; }
 
 void Level::setTitleVisibility(const float& alpha) { m_inUse.instances[m_titleIndex].textureAlpha = alpha; }
 
-void Level::setTitle(const std::string& textureId) { m_inUse.instances[m_titleIndex].textureIndex = m_textureManager->getTextureId(textureId); }
+void Level::setTitle(const std::string& textureId) { m_inUse.instances[m_titleIndex].textureIndex = getTextureId(textureId); }
 
 void Level::setSubtitleVisibility(const float& alpha) { m_inUse.instances[m_subtitleIndex].textureAlpha = alpha; }
 
-void Level::setSubtitle(const std::string& textureId) { m_inUse.instances[m_subtitleIndex].textureIndex = m_textureManager->getTextureId(textureId); }
+void Level::setSubtitle(const std::string& textureId) { m_inUse.instances[m_subtitleIndex].textureIndex = getTextureId(textureId); }
 
-void Level::setScore(const uint32_t& score) { setNumber(m_scoreCountStartIndex, SCORE_COUNT_DIGITS, score); }
+void Level::setScore(const uint32_t& score) { setNumber(m_inUse.instances, m_scoreCountStartIndex, SCORE_COUNT_DIGITS, score); }
 
-void Level::setLifeCount(const uint32_t& lifeCount) { setNumber(m_livesCountStartIndex, LIFE_COUNT_DIGITS, lifeCount); }
+void Level::setLifeCount(const uint32_t& lifeCount) { setNumber(m_inUse.instances, m_livesCountStartIndex, LIFE_COUNT_DIGITS, lifeCount); }
 
 std::vector<Instance>& Level::getInstances() { return m_inUse.instances; };
 
-const BrickType& Level::getBrickData(const uint32_t& id) const { return m_brickTypes.find(id)->second; }
+const std::vector<Instance>& Level::getInstances() const { return m_inUse.instances; };
+
+FixedVec2& Level::getFixedPadPosition() { return m_inUse.fixedPadPosition; }
+
+std::vector<FixedVec2>& Level::getFixedBallPositions() { return m_inUse.fixedBallPositions; }
+
+const BrickType& Level::getBrickData(const uint32_t& id) const { return m_brickTypes[id]; }
 
 const uint32_t& Level::getRemainingBrickCount() const { return m_inUse.remainingBrickCount; }
 
 const uint32_t& Level::getTotalBrickCount() const { return m_totalBrickCount; }
 
+const uint64_t& Level::getTextureLookupCount() const { return m_textureLookupCount; }
+
 Instance* const Level::getBricksPtr() { return &m_inUse.instances[BRICK_START_INDEX]; }
 
-const uint32_t& Level::destroyBrick() {
+const BrickGrid& Level::getBrickGrid() const { return m_brickGrid; }
+
+const BrickColliders& Level::getBrickColliders() const { return m_inUse.brickColliders; }
+
+const uint32_t& Level::damageBrick(const uint32_t& brickIndex) {
+    Instance& brick = m_inUse.instances[BRICK_START_INDEX + brickIndex];
+    assert(brick.health > 0 && brick.maxHealth < UINT32_MAX);
+
+    m_inUse.brickHealthHash ^= hashBrickHealth(brickIndex, brick.health);
+    --brick.health;
+    m_inUse.brickHealthHash ^= hashBrickHealth(brickIndex, brick.health);
+    return brick.health;
+}
+
+const uint32_t& Level::destroyBrick(const uint32_t& brickIndex) {
+    BrickColliders& colliders = m_inUse.brickColliders;
+    if (brickIndex >= m_rowCount * m_columnCount) {
+        colliders.freeBricks.remove(brickIndex);
+    } else {
+        const uint32_t row = brickIndex / m_columnCount;
+        colliders.aliveColumns[row] &= ~(1ull << (brickIndex % m_columnCount));
+        if (colliders.aliveColumns[row] == 0) {
+            colliders.aliveRows &= ~(1ull << row);
+        }
+    }
+
     --m_inUse.remainingBrickCount;
     return m_inUse.remainingBrickCount;
 }
 
+void Level::moveRows(const uint32_t& frameTime /*microseconds*/) {
+    BrickColliders& colliders = m_inUse.brickColliders;
+    for (uint64_t rows = colliders.movingRows & colliders.aliveRows; rows != 0; rows &= rows - 1) {
+        uint32_t row          = countTrailingZeros(rows);
+        Fixed&   offset       = colliders.rowOffsets[row];
+        Fixed&   displacement = colliders.rowDisplacements[row];
+        float&   velocity     = colliders.rowVelocities[row];
+
+        offset += displacement;
+        Fixed target = offset + toFixed(velocity * frameTime);
+        if (target < colliders.rowMinOffsets[row] || target > colliders.rowMaxOffsets[row]) {
+            target   = std::clamp(target, colliders.rowMinOffsets[row], colliders.rowMaxOffsets[row]);
+            velocity = -velocity;
+        }
+        displacement = target - offset;
+    }
+}
+
 const glm::vec2 Level::getWindowDimensions() const { return {m_windowWidth, m_windowHeight}; }
 
 const uint32_t& Level::getBallIndex() const { return m_ballIndex; }
 
-const glm::vec2 Level::getStartingBallDirection() const {
-    float padXOffset = m_inUse.instances[PAD_INDEX].position.x - m_wallWidth - m_playAreaWidth * 0.5f;
-    return glm::normalize(glm::vec2(padXOffset * 1.2f, -m_playAreaWidth));
+const uint32_t& Level::getBallCount() const { return m_ballCount; }
+
+const uint32_t& Level::getActiveBallCount() const { return m_inUse.activeBallCount; }
+
+const bool Level::isBallActive(const uint32_t& ball) const { return m_inUse.instances[m_ballIndex + ball].health > 0; }
+
+void Level::deactivateBall(const uint32_t& ball) {
+    // Like destroyed bricks, balls with no health are not drawn
+    m_inUse.instances[m_ballIndex + ball].health = 0;
+    --m_inUse.activeBallCount;
+}
+
+const float Level::getAttachedBallOffset(const uint32_t& ball) const {
+    return ((ball + 0.5f) / m_ballCount - 0.5f) * m_attachedBallSpread;
+}
+
+const glm::vec2 Level::getStartingBallDirection(const uint32_t& ball) const {
+    float     padXOffset = m_inUse.instances[PAD_INDEX].position.x - m_wallWidth - m_playAreaWidth * 0.5f;
+    glm::vec2 direction  = glm::normalize(glm::vec2(padXOffset * 1.2f, -m_playAreaWidth));
+
+    if (m_ballCount == 1) {
+        return direction;
+    }
+
+    // Tilted by a sideways offset rather than rotated with sin and cos, so only correctly rounded operations are used and fixed point physics starts
+    // from the same directions on every machine
+    float offset = ((ball + 0.5f) / m_ballCount - 0.5f) * MULTIBALL_SPREAD;
+    return glm::normalize(direction + glm::vec2(-direction.y, direction.x) * offset);
 }
 
 const float& Level::getBasePadSpeed() const { return m_basePadSpeed; }
 
 const float& Level::getBaseBallSpeed() const { return m_baseBallSpeed; }
 
+const uint32_t& Level::getPadSound() const { return m_padSound; }
+
+const uint32_t& Level::getWallSound() const { return m_wallSound; }
+
+const uint32_t& Level::getLostLifeSound() const { return m_lostLifeSound; }
+
 void Level::resetPadAndBall() {
-    m_inUse.instances[PAD_INDEX].position   = m_padInitialPosition;
-    m_inUse.instances[m_ballIndex].position = m_ballInitialPosition;
+    m_inUse.instances[PAD_INDEX].position = m_padInitialPosition;
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        m_inUse.instances[m_ballIndex + i].position = {m_ballInitialPosition.x + getAttachedBallOffset(i), m_ballInitialPosition.y};
+        m_inUse.instances[m_ballIndex + i].health   = m_backup.instances[m_ballIndex + i].health;
+    }
+    m_inUse.activeBallCount = m_ballCount;
+    placeFixedPositions(m_inUse);
+    storePreviousPositions();
 }
 
-void Level::setNumber(const uint32_t& instanceIndex, const uint32_t& digitCount, uint32_t number) {
+const uint64_t Level::getStateHash(const bool& fixedPoint) const {
+    const std::vector<Instance>& instances = m_inUse.instances;
+    const BrickColliders&        colliders = m_inUse.brickColliders;
+
+    // Mixing rounds are chained one after another, so pairs of 32 bit values are mixed in together, fixed point positions fit in 32 bits
+    const glm::vec2& padPosition = instances[PAD_INDEX].position;
+    const FixedVec2& padFixed    = m_inUse.fixedPadPosition;
+    uint64_t         padBits     = fixedPoint ? packPair(static_cast<uint32_t>(padFixed.x), static_cast<uint32_t>(padFixed.y))
+                                              : packPair(floatBits(padPosition.x), floatBits(padPosition.y));
+    uint64_t         hash        = hashCombine(m_inUse.brickHealthHash, padBits);
+    uint64_t         activeBalls = 0;
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        const Instance&  ball      = instances[m_ballIndex + i];
+        const FixedVec2& ballFixed = m_inUse.fixedBallPositions[i];
+        hash = hashCombine(hash, fixedPoint ? packPair(static_cast<uint32_t>(ballFixed.x), static_cast<uint32_t>(ballFixed.y))
+                                            : packPair(floatBits(ball.position.x), floatBits(ball.position.y)));
+        activeBalls |= static_cast<uint64_t>(ball.health > 0) << (i % 64);
+
+        // Every 64 balls fill a mask, the last one is mixed in after the loop
+        if (i % 64 == 63 && i + 1 < m_ballCount) {
+            hash        = hashCombine(hash, activeBalls);
+            activeBalls = 0;
+        }
+    }
+    hash = hashCombine(hash, activeBalls);
+
+    for (uint64_t rows = colliders.movingRows & colliders.aliveRows; rows != 0; rows &= rows - 1) {
+        uint32_t row = countTrailingZeros(rows);
+        hash         = hashCombine(hash, packPair(static_cast<uint32_t>(colliders.rowOffsets[row]), static_cast<uint32_t>(colliders.rowDisplacements[row])));
+    }
+
+    return hash;
+}
+
+void Level::captureSnapshot(LevelSnapshot& snapshot) const {
+    const std::vector<Instance>& instances = m_inUse.instances;
+    const BrickColliders&        colliders = m_inUse.brickColliders;
+
+    snapshot.remainingBrickCount = m_inUse.remainingBrickCount;
+    snapshot.activeBallCount     = m_inUse.activeBallCount;
+    snapshot.brickCount          = m_totalBrickCount;
+    snapshot.ballCount           = m_ballCount;
+    snapshot.padPosition         = instances[PAD_INDEX].position;
+    snapshot.fixedPadPosition    = m_inUse.fixedPadPosition;
+
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        snapshot.ballPositions[i]      = instances[m_ballIndex + i].position;
+        snapshot.ballHealth[i]         = instances[m_ballIndex + i].health;
+        snapshot.fixedBallPositions[i] = m_inUse.fixedBallPositions[i];
+    }
+
+    for (uint32_t i = 0; i < m_totalBrickCount; ++i) {
+        snapshot.brickHealth[i] = instances[BRICK_START_INDEX + i].health;
+    }
+    snapshot.brickHealthHash = m_inUse.brickHealthHash;
+
+    snapshot.aliveRows = colliders.aliveRows;
+    for (uint32_t i = 0; i < m_rowCount; ++i) {
+        snapshot.aliveColumns[i]     = colliders.aliveColumns[i];
+        snapshot.rowVelocities[i]    = colliders.rowVelocities[i];
+        snapshot.rowOffsets[i]       = colliders.rowOffsets[i];
+        snapshot.rowDisplacements[i] = colliders.rowDisplacements[i];
+    }
+
+    snapshot.foregroundAlpha = instances[m_foregroundIndex].textureAlpha;
+    snapshot.titleTexture    = instances[m_titleIndex].textureIndex;
+    snapshot.titleAlpha      = instances[m_titleIndex].textureAlpha;
+    snapshot.subtitleTexture = instances[m_subtitleIndex].textureIndex;
+    snapshot.subtitleAlpha   = instances[m_subtitleIndex].textureAlpha;
+    for (uint32_t i = 0; i < LIFE_COUNT_DIGITS; ++i) {
+        snapshot.lifeDigitTextures[i] = instances[m_livesCountStartIndex + i].textureIndex;
+    }
+    for (uint32_t i = 0; i < SCORE_COUNT_DIGITS; ++i) {
+        snapshot.scoreDigitTextures[i] = instances[m_scoreCountStartIndex + i].textureIndex;
+    }
+}
+
+void Level::restoreSnapshot(const LevelSnapshot& snapshot) {
+    assert(snapshot.brickCount == m_totalBrickCount && snapshot.ballCount == m_ballCount);
+
+    std::vector<Instance>& instances = m_inUse.instances;
+    BrickColliders&        colliders = m_inUse.brickColliders;
+
+    m_inUse.remainingBrickCount   = snapshot.remainingBrickCount;
+    m_inUse.activeBallCount       = snapshot.activeBallCount;
+    instances[PAD_INDEX].position = snapshot.padPosition;
+    m_inUse.fixedPadPosition      = snapshot.fixedPadPosition;
+
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        instances[m_ballIndex + i].position = snapshot.ballPositions[i];
+        instances[m_ballIndex + i].health   = snapshot.ballHealth[i];
+        m_inUse.fixedBallPositions[i]       = snapshot.fixedBallPositions[i];
+    }
+
+    for (uint32_t i = 0; i < m_totalBrickCount; ++i) {
+        instances[BRICK_START_INDEX + i].health = snapshot.brickHealth[i];
+    }
+    m_inUse.brickHealthHash = snapshot.brickHealthHash;
+
+    colliders.aliveRows = snapshot.aliveRows;
+    for (uint32_t i = 0; i < m_rowCount; ++i) {
+        colliders.aliveColumns[i]     = snapshot.aliveColumns[i];
+        colliders.rowVelocities[i]    = snapshot.rowVelocities[i];
+        colliders.rowOffsets[i]       = snapshot.rowOffsets[i];
+        colliders.rowDisplacements[i] = snapshot.rowDisplacements[i];
+    }
+
+    // Bricks off the grid are taken out of the hash only when they break, bricks that never had health are never taken out
+    colliders.freeBricks.relink([&](const uint32_t& brickIndex) {
+        const Instance& brick = instances[BRICK_START_INDEX + brickIndex];
+        return brick.health > 0 || brick.maxHealth == 0;
+    });
+
+    instances[m_foregroundIndex].textureAlpha = snapshot.foregroundAlpha;
+    instances[m_titleIndex].textureIndex      = snapshot.titleTexture;
+    instances[m_titleIndex].textureAlpha      = snapshot.titleAlpha;
+    instances[m_subtitleIndex].textureIndex   = snapshot.subtitleTexture;
+    instances[m_subtitleIndex].textureAlpha   = snapshot.subtitleAlpha;
+    for (uint32_t i = 0; i < LIFE_COUNT_DIGITS; ++i) {
+        instances[m_livesCountStartIndex + i].textureIndex = snapshot.lifeDigitTextures[i];
+    }
+    for (uint32_t i = 0; i < SCORE_COUNT_DIGITS; ++i) {
+        instances[m_scoreCountStartIndex + i].textureIndex = snapshot.scoreDigitTextures[i];
+    }
+
+    storePreviousPositions();
+}
+
+const uint32_t Level::getTextureId([[maybe_unused]] const std::string& textureId, [[maybe_unused]] const float& scale) {
+    ++m_textureLookupCount;
+#ifdef BREAKOUT_HEADLESS
+    return 0;
+#else
+    return m_textureManager->getTextureId(textureId, scale);
+#endif
+}
+
+const uint32_t Level::getSoundHandle(const std::string& soundId) {
+    if (soundId.empty()) {
+        return NO_SOUND;
+    }
+#ifdef BREAKOUT_HEADLESS
+    return 0;
+#else
+    return m_soundManager->getSoundHandle(soundId);
+#endif
+}
+
+void Level::setNumber(std::vector<Instance>& instances, const uint32_t& instanceIndex, const uint32_t& digitCount, uint32_t number) {
     for (size_t i = 0; i < digitCount; ++i) {
-        m_inUse.instances[instanceIndex - i - 1 + digitCount].textureIndex = m_textureManager->getTextureId(TEXTURE_UI_NUMBER(number % 10));
+        instances[instanceIndex - i - 1 + digitCount].textureIndex = m_digitTextureIds[number % 10];
         number /= 10;
     }
 }
@@ -110,7 +440,7 @@ void Level::parseXml(const char* fullLevelPath) {
 
     if (levelXml.LoadFile(fullLevelPath)) {
         char error[512];
-        sprintf_s(error, "Failed to open file at location %s!", fullLevelPath);
+        snprintf(error, sizeof(error), "Failed to open file at location %s!", fullLevelPath);
         throw std::runtime_error(error);
     }
 
@@ -122,11 +452,28 @@ void Level::parseXml(const char* fullLevelPath) {
     levelData->FindAttribute("ColumnSpacing")->QueryUnsignedValue(&m_columnSpacing);
     m_backgroundTexturePath = levelData->FindAttribute("BackgroundTexture")->Value();
 
-    m_totalBrickCount = m_rowCount * m_columnCount;
+    if (levelData->FindAttribute("BallCount")) {
+        levelData->FindAttribute("BallCount")->QueryUnsignedValue(&m_ballCount);
+        m_ballCount = std::max(m_ballCount, 1u);
+    }
+
+    if (m_ballCount > MAX_BALL_COUNT) {
+        char error[512];
+        snprintf(error, sizeof(error), "Level at location %s exceeds the maximum of %d balls!", fullLevelPath, MAX_BALL_COUNT);
+        throw std::runtime_error(error);
+    }
 
+    if (m_rowCount > MAX_ROW_COUNT || m_columnCount > MAX_COLUMN_COUNT) {
+        char error[512];
+        snprintf(error, sizeof(error), "Level at location %s exceeds the maximum of %d rows and %d columns!", fullLevelPath, MAX_ROW_COUNT, MAX_COLUMN_COUNT);
+        throw std::runtime_error(error);
+    }
+
+    // Id 0 is the empty cell, without a texture, the rest are numbered in the order they are declared
     std::map<const std::string, uint32_t> idNameMap;
-    idNameMap["_"]     = 0;
-    uint32_t idCounter = 1;
+    idNameMap["_"] = 0;
+    m_brickTypes.resize(1);
+    m_brickTypes[0].textureId = getTextureId("");
 
     const tinyxml2::XMLElement* brickTypesNode = levelData->FirstChildElement("BrickTypes");
 
@@ -135,11 +482,10 @@ void Level::parseXml(const char* fullLevelPath) {
         BrickType brick;
 
         const std::string brickId = brickTypeElement->FindAttribute("Id")->Value();
-        idNameMap[brickId]        = idCounter;
-        brick.id                  = idCounter;
-        ++idCounter;
+        brick.id                  = static_cast<uint32_t>(m_brickTypes.size());
+        idNameMap[brickId]        = brick.id;
 
-        brick.texturePath     = brickTypeElement->FindAttribute("Texture")->Value();
+        brick.textureId       = getTextureId(brickTypeElement->FindAttribute("Texture")->Value());
         const char* hitPoints = brickTypeElement->FindAttribute("HitPoints")->Value();
         if (!strcmp(hitPoints, "Infinite")) {
             brick.hitPoints = UINT32_MAX;
@@ -148,55 +494,138 @@ void Level::parseXml(const char* fullLevelPath) {
         }
 
         if (brickTypeElement->FindAttribute("HitSound")) {
-            brick.hitSoundPath = brickTypeElement->FindAttribute("HitSound")->Value();
+            brick.hitSound = getSoundHandle(brickTypeElement->FindAttribute("HitSound")->Value());
         }
 
         if (brickTypeElement->FindAttribute("BreakSound")) {
-            brick.breakSoundPath = brickTypeElement->FindAttribute("BreakSound")->Value();
+            brick.breakSound = getSoundHandle(brickTypeElement->FindAttribute("BreakSound")->Value());
         }
 
         if (brickTypeElement->FindAttribute("BreakScore")) {
             brickTypeElement->FindAttribute("BreakScore")->QueryIntValue(&brick.breakScore);
         }
 
-        m_brickTypes[brick.id] = brick;
+        m_brickTypes.push_back(brick);
     }
 
-    std::string layoutData = levelData->FirstChildElement("Bricks")->GetText();
-    layoutData.erase(std::remove(layoutData.begin(), layoutData.end(), '\t'), layoutData.end());
-    uint32_t start = 0;
-    uint32_t end   = static_cast<uint32_t>(layoutData.length()) - 1;
-    if (layoutData[0] == '\n') {
-        ++start;
-    }
-    while (layoutData[end] == '\n' || layoutData[end] == ' ') {
-        --end;
-    }
-    layoutData = layoutData.substr(start, end);
-
-    std::string       line;
-    std::stringstream lineFeed(layoutData);
-    while (std::getline(lineFeed, line, '\n')) {
-        std::vector<uint32_t> row;
-        std::string           blockName;
-        std::stringstream     wordFeed(line);
-        while (std::getline(wordFeed, blockName, ' ')) {
-            auto id = idNameMap.find(blockName);
-            if (id != idNameMap.end()) {
-                row.push_back(id->second);
+    // Rows are either declared one by one as Row elements, which may move, or all together as lines of text, which stay in place. Bricks off the grid are
+    // declared one by one as Brick elements next to either
+    const tinyxml2::XMLElement* bricksNode = levelData->FirstChildElement("Bricks");
+    if (bricksNode->FirstChildElement("Row")) {
+        for (const tinyxml2::XMLElement* rowElement = bricksNode->FirstChildElement("Row"); rowElement != NULL;
+             rowElement                             = rowElement->NextSiblingElement("Row")) {
+            float velocity = 0.0f;
+            float range    = 1.0f;
+            if (rowElement->FindAttribute("Velocity")) {
+                rowElement->FindAttribute("Velocity")->QueryFloatValue(&velocity);
+            }
+            if (rowElement->FindAttribute("Range")) {
+                rowElement->FindAttribute("Range")->QueryFloatValue(&range);
             }
+
+            m_levelLayout.push_back(parseRow(rowElement->GetText() ? rowElement->GetText() : "", idNameMap));
+            m_rowVelocityRatios.push_back(velocity);
+            m_rowRangeRatios.push_back(std::max(range, 0.0f));
+        }
+    } else if (bricksNode->GetText()) {
+        std::string layoutData = bricksNode->GetText();
+        layoutData.erase(std::remove(layoutData.begin(), layoutData.end(), '\t'), layoutData.end());
+        uint32_t start = 0;
+        uint32_t end   = static_cast<uint32_t>(layoutData.length()) - 1;
+        if (layoutData[0] == '\n') {
+            ++start;
         }
-        while (row.size() < m_columnCount) {
-            row.push_back(0);
+        while (layoutData[end] == '\n' || layoutData[end] == ' ') {
+            --end;
         }
+        layoutData = layoutData.substr(start, end);
 
-        m_levelLayout.push_back(row);
+        std::string       line;
+        std::stringstream lineFeed(layoutData);
+        while (std::getline(lineFeed, line, '\n')) {
+            m_levelLayout.push_back(parseRow(line, idNameMap));
+        }
+    }
+
+    if (m_levelLayout.size() > m_rowCount) {
+        char error[512];
+        snprintf(error, sizeof(error), "Level at location %s declares more rows of bricks than its row count of %d!", fullLevelPath, m_rowCount);
+        throw std::runtime_error(error);
     }
 
     while (m_levelLayout.size() < m_rowCount) {
         std::vector<uint32_t> row(m_columnCount, 0);
         m_levelLayout.push_back(row);
     }
+
+    m_rowVelocityRatios.resize(m_rowCount, 0.0f);
+    m_rowRangeRatios.resize(m_rowCount, 0.0f);
+
+    // Positions and dimensions in grid cells, anywhere within the columns of the level and the rows of the largest grid
+    for (const tinyxml2::XMLElement* brickElement = bricksNode->FirstChildElement("Brick"); brickElement != NULL;
+         brickElement                             = brickElement->NextSiblingElement("Brick")) {
+        const char* typeName = brickElement->Attribute("Type");
+        auto        id       = typeName ? idNameMap.find(typeName) : idNameMap.end();
+        if (id == idNameMap.end() || id->second == 0) {
+            char error[512];
+            snprintf(error, sizeof(error), "Level at location %s places a brick of unknown type %s!", fullLevelPath, typeName ? typeName : "");
+            throw std::runtime_error(error);
+        }
+
+        FreeBrick brick;
+        brick.typeId = id->second;
+        if (brickElement->FindAttribute("Column")) {
+            brickElement->FindAttribute("Column")->QueryFloatValue(&brick.position.x);
+        }
+        if (brickElement->FindAttribute("Row")) {
+            brickElement->FindAttribute("Row")->QueryFloatValue(&brick.position.y);
+        }
+        if (brickElement->FindAttribute("Width")) {
+            brickElement->FindAttribute("Width")->QueryFloatValue(&brick.dimensions.x);
+        }
+        if (brickElement->FindAttribute("Height")) {
+            brickElement->FindAttribute("Height")->QueryFloatValue(&brick.dimensions.y);
+        }
+
+        if (brick.dimensions.x <= 0.0f || brick.dimensions.y <= 0.0f || brick.position.x < 0.0f || brick.position.y < 0.0f ||
+            brick.position.x + brick.dimensions.x > m_columnCount || brick.position.y + brick.dimensions.y > MAX_ROW_COUNT) {
+            char error[512];
+            snprintf(error, sizeof(error), "Level at location %s places a brick outside of the play area at column %.2f, row %.2f!", fullLevelPath,
+                     brick.position.x, brick.position.y);
+            throw std::runtime_error(error);
+        }
+
+        if (m_freeBricks.size() == MAX_FREE_BRICK_COUNT) {
+            char error[512];
+            snprintf(error, sizeof(error), "Level at location %s exceeds the maximum of %d bricks off the grid!", fullLevelPath, MAX_FREE_BRICK_COUNT);
+            throw std::runtime_error(error);
+        }
+
+        m_freeBricks.push_back(brick);
+    }
+
+    m_totalBrickCount = m_rowCount * m_columnCount + static_cast<uint32_t>(m_freeBricks.size());
+}
+
+std::vector<uint32_t> Level::parseRow(const std::string& line, const std::map<const std::string, uint32_t>& idNameMap) const {
+    // Row elements may be indented with tabs and span several lines
+    std::string words = line;
+    std::replace_if(words.begin(), words.end(), [](const char& c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+
+    std::vector<uint32_t> row;
+    std::string           blockName;
+    std::stringstream     wordFeed(words);
+    while (std::getline(wordFeed, blockName, ' ')) {
+        auto id = idNameMap.find(blockName);
+        if (id != idNameMap.end()) {
+            row.push_back(id->second);
+        }
+    }
+    while (row.size() < m_columnCount) {
+        row.push_back(0);
+    }
+
+    return row;
 }
 
 void Level::generateRenderData() {
@@ -227,19 +656,19 @@ void Level::generateRenderData() {
 
     uint32_t totalUiCount = 5 + LEVEL_COUNT_DIGITS + LIFE_COUNT_DIGITS + SCORE_COUNT_DIGITS;
 #pragma warning(suppress : 26451) // Arithmetic overflow : Using operator'+' on a 4 byte value and then casting the result to a 8 byte value
-    m_backup.instances = std::vector<Instance>(BRICK_START_INDEX + m_totalBrickCount + 2 + totalUiCount, defaultInstance);
+    m_backup.instances = std::vector<Instance>(BRICK_START_INDEX + m_totalBrickCount + m_ballCount + 1 + totalUiCount, defaultInstance);
 
     // Background
     m_backup.instances[BACKGROUND_INDEX].position     = {m_windowWidth * 0.5f, m_windowHeight * 0.5f};
     m_backup.instances[BACKGROUND_INDEX].depth        = DEPTH_BACKGROUND;
     m_backup.instances[BACKGROUND_INDEX].scale        = {m_windowWidth, m_windowHeight};
-    m_backup.instances[BACKGROUND_INDEX].textureIndex = m_textureManager->getTextureId(m_backgroundTexturePath);
+    m_backup.instances[BACKGROUND_INDEX].textureIndex = getTextureId(m_backgroundTexturePath);
 
     // Left wall
     m_backup.instances[LEFT_WALL_INDEX].position     = {m_wallWidth * 0.5f, m_windowHeight * 0.5f};
     m_backup.instances[LEFT_WALL_INDEX].depth        = DEPTH_GAME;
     m_backup.instances[LEFT_WALL_INDEX].scale        = {m_wallWidth, m_windowHeight};
-    m_backup.instances[LEFT_WALL_INDEX].textureIndex = m_textureManager->getTextureId(m_backgroundTexturePath, SIDE_BLUR_STRENGTH);
+    m_backup.instances[LEFT_WALL_INDEX].textureIndex = getTextureId(m_backgroundTexturePath, SIDE_BLUR_STRENGTH);
     m_backup.instances[LEFT_WALL_INDEX].uvOffset     = {0.0f, 0.0f};
     m_backup.instances[LEFT_WALL_INDEX].uvScale      = {m_wallWidth / static_cast<float>(m_windowWidth), 1.0f};
 
@@ -247,7 +676,7 @@ void Level::generateRenderData() {
     m_backup.instances[RIGHT_WALL_INDEX].position     = {static_cast<float>(m_windowWidth) - m_wallWidth * 0.5f, m_windowHeight * 0.5f};
     m_backup.instances[RIGHT_WALL_INDEX].depth        = DEPTH_GAME;
     m_backup.instances[RIGHT_WALL_INDEX].scale        = {m_wallWidth, m_windowHeight};
-    m_backup.instances[RIGHT_WALL_INDEX].textureIndex = m_textureManager->getTextureId(m_backgroundTexturePath, SIDE_BLUR_STRENGTH);
+    m_backup.instances[RIGHT_WALL_INDEX].textureIndex = getTextureId(m_backgroundTexturePath, SIDE_BLUR_STRENGTH);
     m_backup.instances[RIGHT_WALL_INDEX].uvOffset     = {m_windowWidth - m_wallWidth / static_cast<float>(m_windowWidth), 0.0f};
     m_backup.instances[RIGHT_WALL_INDEX].uvScale      = {m_wallWidth / static_cast<float>(m_windowWidth), 1.0f};
 
@@ -256,12 +685,24 @@ void Level::generateRenderData() {
     m_backup.instances[PAD_INDEX].position     = m_padInitialPosition;
     m_backup.instances[PAD_INDEX].depth        = DEPTH_GAME;
     m_backup.instances[PAD_INDEX].scale        = padDimensions;
-    m_backup.instances[PAD_INDEX].textureIndex = m_textureManager->getTextureId(TEXTURE_PAD);
+    m_backup.instances[PAD_INDEX].textureIndex = getTextureId(TEXTURE_PAD);
 
     // Bricks
     uint32_t instanceDataIndex = BRICK_START_INDEX;
     float    offsetY           = m_rowSpacing + 0.5f * brickHeight;
     float    stepY             = m_rowSpacing + brickHeight;
+
+    m_brickGrid.origin         = {m_wallWidth + 0.5f * m_columnSpacing, 0.5f * m_rowSpacing};
+    m_brickGrid.cellDimensions = {m_columnSpacing + brickWidth, stepY};
+    m_brickGrid.rowCount       = m_rowCount;
+    m_brickGrid.columnCount    = m_columnCount;
+
+    BrickColliders& colliders = m_backup.brickColliders;
+    colliders.x.resize(m_totalBrickCount + COLLIDER_PADDING);
+    colliders.y.resize(m_totalBrickCount + COLLIDER_PADDING);
+    colliders.halfWidth.resize(m_totalBrickCount + COLLIDER_PADDING);
+    colliders.halfHeight.resize(m_totalBrickCount + COLLIDER_PADDING);
+    colliders.aliveColumns.resize(m_rowCount);
     for (size_t i = 0; i < m_levelLayout.size(); ++i, offsetY += stepY) {
         std::vector<uint32_t>& brickRow = m_levelLayout[i];
         float                  offsetX  = m_wallWidth + m_columnSpacing + 0.5f * brickWidth;
@@ -272,10 +713,21 @@ void Level::generateRenderData() {
             m_backup.instances[instanceDataIndex].position     = {offsetX, offsetY};
             m_backup.instances[instanceDataIndex].depth        = DEPTH_GAME;
             m_backup.instances[instanceDataIndex].scale        = {brickWidth, brickHeight};
-            m_backup.instances[instanceDataIndex].textureIndex = m_textureManager->getTextureId(m_brickTypes[m_levelLayout[i][j]].texturePath);
+            m_backup.instances[instanceDataIndex].textureIndex = m_brickTypes[m_levelLayout[i][j]].textureId;
             m_backup.instances[instanceDataIndex].health       = brickMaxHealth;
             m_backup.instances[instanceDataIndex].maxHealth    = brickMaxHealth;
 
+            const uint32_t brickIndex        = instanceDataIndex - BRICK_START_INDEX;
+            colliders.x[brickIndex]          = offsetX;
+            colliders.y[brickIndex]          = offsetY;
+            colliders.halfWidth[brickIndex]  = 0.5f * brickWidth;
+            colliders.halfHeight[brickIndex] = 0.5f * brickHeight;
+
+            if (brickMaxHealth > 0) {
+                colliders.aliveColumns[i] |= 1ull << j;
+                colliders.aliveRows |= 1ull << i;
+            }
+
             if (brickMaxHealth > 0 && brickMaxHealth < UINT32_MAX) {
                 ++m_backup.remainingBrickCount;
             }
@@ -284,21 +736,103 @@ void Level::generateRenderData() {
         }
     }
 
-    // The ball
-    m_ballIndex                                  = instanceDataIndex;
-    m_ballInitialPosition                        = {m_windowWidth * 0.5f, padOffset - (0.5f * padDimensions.y + ballRadius + 1.0f)};
-    m_backup.instances[m_ballIndex].position     = m_ballInitialPosition;
-    m_backup.instances[m_ballIndex].depth        = DEPTH_GAME;
-    m_backup.instances[m_ballIndex].scale        = {2.0f * ballRadius, 2.0f * ballRadius};
-    m_backup.instances[m_ballIndex].textureIndex = m_textureManager->getTextureId(TEXTURE_BALL);
-    ++instanceDataIndex;
+    // Bricks off the grid, each the size of the cells it covers less the spacing, like the bricks on the grid
+    uint32_t hashCellCapacity = 0;
+    for (const FreeBrick& freeBrick : m_freeBricks) {
+        hashCellCapacity += static_cast<uint32_t>((std::ceil(freeBrick.dimensions.x) + 1.0f) * (std::ceil(freeBrick.dimensions.y) + 1.0f));
+    }
+    colliders.freeBricks.reset(m_brickGrid.origin, m_brickGrid.cellDimensions, hashCellCapacity);
+
+    for (const FreeBrick& freeBrick : m_freeBricks) {
+        const BrickType& brickType  = m_brickTypes[freeBrick.typeId];
+        const glm::vec2  spacing    = {m_columnSpacing, m_rowSpacing};
+        const glm::vec2  brickMin   = m_brickGrid.origin + freeBrick.position * m_brickGrid.cellDimensions + 0.5f * spacing;
+        const glm::vec2  brickMax   = m_brickGrid.origin + (freeBrick.position + freeBrick.dimensions) * m_brickGrid.cellDimensions - 0.5f * spacing;
+        const glm::vec2  center     = 0.5f * (brickMin + brickMax);
+        const glm::vec2  dimensions = brickMax - brickMin;
+
+        m_backup.instances[instanceDataIndex].id           = brickType.id;
+        m_backup.instances[instanceDataIndex].position     = center;
+        m_backup.instances[instanceDataIndex].depth        = DEPTH_GAME;
+        m_backup.instances[instanceDataIndex].scale        = dimensions;
+        m_backup.instances[instanceDataIndex].textureIndex = brickType.textureId;
+        m_backup.instances[instanceDataIndex].health       = brickType.hitPoints;
+        m_backup.instances[instanceDataIndex].maxHealth    = brickType.hitPoints;
+
+        const uint32_t brickIndex        = instanceDataIndex - BRICK_START_INDEX;
+        colliders.x[brickIndex]          = center.x;
+        colliders.y[brickIndex]          = center.y;
+        colliders.halfWidth[brickIndex]  = 0.5f * dimensions.x;
+        colliders.halfHeight[brickIndex] = 0.5f * dimensions.y;
+        colliders.freeBricks.insert(brickIndex, brickMin, brickMax);
+
+        if (brickType.hitPoints < UINT32_MAX) {
+            ++m_backup.remainingBrickCount;
+        }
+
+        ++instanceDataIndex;
+    }
+
+    // Bricks are hashed once, damage updates the hash from then on
+    for (uint32_t i = 0; i < m_totalBrickCount; ++i) {
+        m_backup.brickHealthHash ^= hashBrickHealth(i, m_backup.instances[BRICK_START_INDEX + i].health);
+    }
+
+    // Moving rows, each kept to its declared range and far enough from the walls that a ball always fits between the wall and the row, so the row can never
+    // squeeze a ball against a wall
+    colliders.rowVelocities.resize(m_rowCount, 0.0f);
+    colliders.rowOffsets.resize(m_rowCount, 0);
+    colliders.rowDisplacements.resize(m_rowCount, 0);
+    colliders.rowMinOffsets.resize(m_rowCount, 0);
+    colliders.rowMaxOffsets.resize(m_rowCount, 0);
+    float maxRowSpeed = MAX_ROW_SPEED_RATIO * m_baseBallSpeed;
+    float ballGap     = 2.0f * ballRadius + 1.0f;
+    for (uint32_t i = 0; i < m_rowCount; ++i) {
+        if (m_rowVelocityRatios[i] == 0.0f || colliders.aliveColumns[i] == 0) {
+            continue;
+        }
+
+        uint32_t firstColumn = countTrailingZeros(colliders.aliveColumns[i]);
+        uint32_t lastColumn  = firstColumn;
+        for (uint64_t columns = colliders.aliveColumns[i] >> (firstColumn + 1); columns != 0; columns >>= 1) {
+            ++lastColumn;
+        }
+
+        float range                = m_rowRangeRatios[i] * m_playAreaWidth;
+        float leftGap              = firstColumn * m_brickGrid.cellDimensions.x + m_columnSpacing;
+        float rightGap             = (m_columnCount - 1 - lastColumn) * m_brickGrid.cellDimensions.x + m_columnSpacing;
+        colliders.rowMinOffsets[i] = toFixed(-std::min(std::max(leftGap - ballGap, 0.0f), range));
+        colliders.rowMaxOffsets[i] = toFixed(std::min(std::max(rightGap - ballGap, 0.0f), range));
+        if (colliders.rowMinOffsets[i] == colliders.rowMaxOffsets[i]) {
+            continue;
+        }
+
+        // Play area widths per second to pixels per microsecond
+        colliders.rowVelocities[i] = std::clamp(m_rowVelocityRatios[i] * m_playAreaWidth * 0.000'001f, -maxRowSpeed, maxRowSpeed);
+        colliders.movingRows |= 1ull << i;
+    }
+
+    // The balls, spread evenly over the pad
+    m_ballIndex           = instanceDataIndex;
+    m_attachedBallSpread  = padDimensions.x - 2.0f * ballRadius;
+    m_ballInitialPosition = {m_windowWidth * 0.5f, padOffset - (0.5f * padDimensions.y + ballRadius + 1.0f)};
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        m_backup.instances[instanceDataIndex].position     = {m_ballInitialPosition.x + getAttachedBallOffset(i), m_ballInitialPosition.y};
+        m_backup.instances[instanceDataIndex].depth        = DEPTH_GAME;
+        m_backup.instances[instanceDataIndex].scale        = {2.0f * ballRadius, 2.0f * ballRadius};
+        m_backup.instances[instanceDataIndex].textureIndex = getTextureId(TEXTURE_BALL);
+        ++instanceDataIndex;
+    }
+    m_backup.activeBallCount = m_ballCount;
+    m_ballPreviousPositions.resize(m_ballCount);
+    placeFixedPositions(m_backup);
 
     // Foreground
     m_foregroundIndex                                  = instanceDataIndex;
     m_backup.instances[m_foregroundIndex].position     = {m_windowWidth * 0.5f, m_windowHeight * 0.5f};
     m_backup.instances[m_foregroundIndex].depth        = DEPTH_FOREGROUND;
     m_backup.instances[m_foregroundIndex].scale        = {m_windowWidth, m_windowHeight};
-    m_backup.instances[m_foregroundIndex].textureIndex = m_textureManager->getTextureId(TEXTURE_FOREGROUND);
+    m_backup.instances[m_foregroundIndex].textureIndex = getTextureId(TEXTURE_FOREGROUND);
     m_backup.instances[m_foregroundIndex].textureAlpha = 1.0f;
     ++instanceDataIndex;
 
@@ -324,13 +858,16 @@ void Level::generateRenderData() {
     float uiLabelHeight = m_windowHeight * 0.05f;
     float uiLabelWidth  = uiLabelHeight * UI_LABEL_RATIO;
     float digitWidth    = m_windowWidth * 0.015f;
+    for (uint32_t i = 0; i < 10; ++i) {
+        m_digitTextureIds[i] = getTextureId(TEXTURE_UI_NUMBER(i));
+    }
 
     float currentLabelHeight                           = m_windowHeight - uiLabelHeight * 0.5f;
     m_scoreLabelIndex                                  = instanceDataIndex;
     m_backup.instances[m_scoreLabelIndex].position     = {0.5f * uiLabelWidth, currentLabelHeight};
     m_backup.instances[m_scoreLabelIndex].depth        = DEPTH_UI;
     m_backup.instances[m_scoreLabelIndex].scale        = {uiLabelWidth, uiLabelHeight};
-    m_backup.instances[m_scoreLabelIndex].textureIndex = m_textureManager->getTextureId(TEXTURE_UI_SCORE);
+    m_backup.instances[m_scoreLabelIndex].textureIndex = getTextureId(TEXTURE_UI_SCORE);
     ++instanceDataIndex;
 
     float scoreDigitPositionX = uiLabelWidth + digitWidth * 0.5f;
@@ -348,7 +885,7 @@ void Level::generateRenderData() {
     m_backup.instances[m_levelLabelIndex].position     = {0.5f * uiLabelWidth, currentLabelHeight};
     m_backup.instances[m_levelLabelIndex].depth        = DEPTH_UI;
     m_backup.instances[m_levelLabelIndex].scale        = {uiLabelWidth, uiLabelHeight};
-    m_backup.instances[m_levelLabelIndex].textureIndex = m_textureManager->getTextureId(TEXTURE_UI_LEVEL);
+    m_backup.instances[m_levelLabelIndex].textureIndex = getTextureId(TEXTURE_UI_LEVEL);
     ++instanceDataIndex;
 
     float levelDigitPositionX = uiLabelWidth + digitWidth * 0.5f;
@@ -366,7 +903,7 @@ void Level::generateRenderData() {
     m_backup.instances[m_livesLabelIndex].position     = {0.5f * uiLabelWidth, currentLabelHeight};
     m_backup.instances[m_livesLabelIndex].depth        = DEPTH_UI;
     m_backup.instances[m_livesLabelIndex].scale        = {uiLabelWidth, uiLabelHeight};
-    m_backup.instances[m_livesLabelIndex].textureIndex = m_textureManager->getTextureId(TEXTURE_UI_LIVES);
+    m_backup.instances[m_livesLabelIndex].textureIndex = getTextureId(TEXTURE_UI_LIVES);
     ++instanceDataIndex;
 
     float lifeDigitPositionX = uiLabelWidth + digitWidth * 0.5f;
@@ -380,6 +917,16 @@ void Level::generateRenderData() {
     }
 
     m_instanceDataBufferSize = VECTOR_SIZE_IN_BYTES(m_backup.instances);
-    m_instanceBuffer         = m_renderer->createBuffer(m_instanceDataBufferSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+#ifndef BREAKOUT_HEADLESS
+    m_instanceBuffer = m_renderer->createBuffer(m_instanceDataBufferSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, "Instance buffer");
+#endif
+}
+
+void Level::placeFixedPositions(DynamicLevelData& data) {
+    data.fixedPadPosition = toFixed(data.instances[PAD_INDEX].position);
+    data.fixedBallPositions.resize(m_ballCount);
+    for (uint32_t i = 0; i < m_ballCount; ++i) {
+        data.fixedBallPositions[i] = toFixed(data.instances[m_ballIndex + i].position);
+    }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "brickHash.h"
 #include "common.h"
+#include "fixedPoint.h"
 #include "sharedStructures.h"
 
 #include "commonExternal.h"
@@ -10,12 +12,20 @@
 
 #define LEVEL_FOLDER "//resources//levels//"
 
+// Rows and columns of bricks are tracked in 64 bit masks
 #define MAX_COLUMN_COUNT 35
 #define MAX_ROW_COUNT    30
 
+// Bricks placed off the grid and balls are kept in fixed size arrays by level snapshots, sized for boards with hundreds of balls
+#define MAX_FREE_BRICK_COUNT 256
+#define MAX_BALL_COUNT       512
+
 #define MAX_COLUMN_SPACING 5
 #define MAX_ROW_SPACING    5
 
+// Extra entries at the end of the brick collider arrays, so batched physics can load a full batch past the last brick
+#define COLLIDER_PADDING 8
+
 #define BACKGROUND_INDEX  0
 #define LEFT_WALL_INDEX   1
 #define RIGHT_WALL_INDEX  2
@@ -35,18 +45,31 @@
 //#define BALL_SPEED_FACTOR 0.00000005f
 #define BALL_SPEED_FACTOR 0.00000025f
 
+// Fastest a row of bricks may move, relative to the base ball speed, so balls always get away from the bricks they bounce off
+#define MAX_ROW_SPEED_RATIO 0.5f
+
+// Sideways offset, relative to the forward direction, the starting directions of multiple balls are spread over, about a radian for the default
+#define MULTIBALL_SPREAD 1.0f
+
+#define SOUND_PAD     "pad.wav"
+#define SOUND_WALL    "wall.wav"
+#define SOUND_WILHELM "wilhelm.wav"
+
+// Sound handle of brick types that make no sound
+#define NO_SOUND UINT32_MAX
+
 #define DEPTH_UI         0.2f
 #define DEPTH_FOREGROUND 0.4f
 #define DEPTH_GAME       0.6f
 #define DEPTH_BACKGROUND 0.8f
 
 /// <summary>
-/// Structure holding static data for a brick type.
+/// Structure holding static data for a brick type, with the textures and sounds resolved when the level is loaded.
 /// </summary>
 struct BrickType {
 
     /// <summary>
-    /// Id of the brick.
+    /// Id of the brick, its index in the brick type table of the level.
     /// </summary>
     uint32_t id = 0;
 
@@ -61,19 +84,112 @@ struct BrickType {
     int32_t breakScore = 0;
 
     /// <summary>
-    /// Path to the texture file of the brick, relative to the textures folder.
+    /// Id of the texture of the brick.
     /// </summary>
-    std::string texturePath = "";
+    uint32_t textureId = 0;
 
     /// <summary>
-    /// Path to the sound file for hitting the brick, relative to the sounds folder.
+    /// Handle of the sound for hitting the brick, NO_SOUND if it has none.
     /// </summary>
-    std::string hitSoundPath = "";
+    uint32_t hitSound = NO_SOUND;
 
     /// <summary>
-    /// Path to the sound file for breaking the brick, relative to the sounds folder.
+    /// Handle of the sound for breaking the brick, NO_SOUND if it has none.
     /// </summary>
-    std::string breakSoundPath = "";
+    uint32_t breakSound = NO_SOUND;
+};
+
+/// <summary>
+/// Structure of arrays holding the brick data physics needs, kept apart from the instance vector so the collision loop only touches what it reads. Arrays
+/// are indexed the same way as the bricks in the instance vector.
+/// </summary>
+struct BrickColliders {
+    /// <summary>
+    /// X coordinates of the brick centers.
+    /// </summary>
+    std::vector<float> x;
+
+    /// <summary>
+    /// Y coordinates of the brick centers.
+    /// </summary>
+    std::vector<float> y;
+
+    /// <summary>
+    /// Half of the brick widths.
+    /// </summary>
+    std::vector<float> halfWidth;
+
+    /// <summary>
+    /// Half of the brick heights.
+    /// </summary>
+    std::vector<float> halfHeight;
+
+    /// <summary>
+    /// Bit mask of the bricks that can still be hit for each row, bit j standing for the brick in column j.
+    /// </summary>
+    std::vector<uint64_t> aliveColumns;
+
+    /// <summary>
+    /// Bit mask of the rows that still have bricks that can be hit, bit i standing for row i.
+    /// </summary>
+    uint64_t aliveRows = 0;
+
+    /// <summary>
+    /// Bit mask of the rows that move sideways, bit i standing for row i. Bricks of a moving row keep their coordinates above, the whole row is shifted by
+    /// its offset, so moving a row never touches its bricks.
+    /// </summary>
+    uint64_t movingRows = 0;
+
+    /// <summary>
+    /// Horizontal velocities of the rows in pixels per microsecond, the sign flipping whenever a row reaches the end of its range.
+    /// </summary>
+    std::vector<float> rowVelocities;
+
+    /// <summary>
+    /// Horizontal offsets of the rows at the start of the current simulation step.
+    /// </summary>
+    std::vector<Fixed> rowOffsets;
+
+    /// <summary>
+    /// Horizontal distances the rows move during the current simulation step.
+    /// </summary>
+    std::vector<Fixed> rowDisplacements;
+
+    /// <summary>
+    /// Smallest offsets the rows may move to.
+    /// </summary>
+    std::vector<Fixed> rowMinOffsets;
+
+    /// <summary>
+    /// Largest offsets the rows may move to.
+    /// </summary>
+    std::vector<Fixed> rowMaxOffsets;
+
+    /// <summary>
+    /// Spatial hash of the bricks that can still be hit among those placed off the grid, keyed on their bounding boxes. Ids are brick indices.
+    /// </summary>
+    BrickHash freeBricks;
+};
+
+/// <summary>
+/// Brick placed off the grid, at any position and of any size. Positions and dimensions are in grid cells, a brick 1 cell wide and 1 cell high is as large as
+/// a brick on the grid.
+/// </summary>
+struct FreeBrick {
+    /// <summary>
+    /// Id of the brick type.
+    /// </summary>
+    uint32_t typeId = 0;
+
+    /// <summary>
+    /// Column and row of the top left corner of the brick.
+    /// </summary>
+    glm::vec2 position = {0.0f, 0.0f};
+
+    /// <summary>
+    /// Width and height of the brick.
+    /// </summary>
+    glm::vec2 dimensions = {1.0f, 1.0f};
 };
 
 /// <summary>
@@ -85,14 +201,189 @@ struct DynamicLevelData {
     /// </summary>
     uint32_t remainingBrickCount = 0;
 
+    /// <summary>
+    /// Amount of balls still in play.
+    /// </summary>
+    uint32_t activeBallCount = 0;
+
     /// <summary>
     /// Vector of instance data, containing info on background, side walls, pad, ball, every brick, foreground and UI.
     /// </summary>
     std::vector<Instance> instances;
+
+    /// <summary>
+    /// Collision data of the bricks, mirrors the bricks in the instance vector.
+    /// </summary>
+    BrickColliders brickColliders;
+
+    /// <summary>
+    /// Exclusive or of a hash of the index and the health of every brick, updated whenever a brick is damaged instead of hashing all the bricks again.
+    /// </summary>
+    uint64_t brickHealthHash = 0;
+
+    /// <summary>
+    /// Position of the pad center in fixed point. Fixed point physics moves this one and only writes the instance position for drawing, the float
+    /// physics leaves it as it was placed.
+    /// </summary>
+    FixedVec2 fixedPadPosition;
+
+    /// <summary>
+    /// Positions of the ball centers in fixed point, kept the same way as the pad's.
+    /// </summary>
+    std::vector<FixedVec2> fixedBallPositions;
+};
+
+/// <summary>
+/// Plain data copy of everything in a level that changes while it is played: the pad, the balls, the health of the bricks, the moving rows and the
+/// overlays. Sized for the largest level, so it can be kept in preallocated buffers, and taken or restored without allocating.
+/// </summary>
+struct LevelSnapshot {
+    /// <summary>
+    /// Amount of breakable bricks still unbroken.
+    /// </summary>
+    uint32_t remainingBrickCount = 0;
+
+    /// <summary>
+    /// Amount of balls still in play.
+    /// </summary>
+    uint32_t activeBallCount = 0;
+
+    /// <summary>
+    /// Number of bricks of the level, on the grid and off it.
+    /// </summary>
+    uint32_t brickCount = 0;
+
+    /// <summary>
+    /// Number of balls of the level.
+    /// </summary>
+    uint32_t ballCount = 0;
+
+    /// <summary>
+    /// Position of the pad center.
+    /// </summary>
+    glm::vec2 padPosition = {0.0f, 0.0f};
+
+    /// <summary>
+    /// Positions of the ball centers.
+    /// </summary>
+    glm::vec2 ballPositions[MAX_BALL_COUNT] = {};
+
+    /// <summary>
+    /// Health of the balls, 0 for the balls out of play.
+    /// </summary>
+    uint32_t ballHealth[MAX_BALL_COUNT] = {};
+
+    /// <summary>
+    /// Position of the pad center in fixed point.
+    /// </summary>
+    FixedVec2 fixedPadPosition;
+
+    /// <summary>
+    /// Positions of the ball centers in fixed point.
+    /// </summary>
+    FixedVec2 fixedBallPositions[MAX_BALL_COUNT] = {};
+
+    /// <summary>
+    /// Health of the bricks, indexed the same way as the bricks in the instance vector.
+    /// </summary>
+    uint32_t brickHealth[MAX_ROW_COUNT * MAX_COLUMN_COUNT + MAX_FREE_BRICK_COUNT] = {};
+
+    /// <summary>
+    /// Hash of the health of the bricks.
+    /// </summary>
+    uint64_t brickHealthHash = 0;
+
+    /// <summary>
+    /// Bit mask of the bricks that can still be hit for each row.
+    /// </summary>
+    uint64_t aliveColumns[MAX_ROW_COUNT] = {};
+
+    /// <summary>
+    /// Bit mask of the rows that still have bricks that can be hit.
+    /// </summary>
+    uint64_t aliveRows = 0;
+
+    /// <summary>
+    /// Horizontal velocities of the rows.
+    /// </summary>
+    float rowVelocities[MAX_ROW_COUNT] = {};
+
+    /// <summary>
+    /// Horizontal offsets of the rows at the start of the simulation step.
+    /// </summary>
+    Fixed rowOffsets[MAX_ROW_COUNT] = {};
+
+    /// <summary>
+    /// Horizontal distances the rows move during the simulation step.
+    /// </summary>
+    Fixed rowDisplacements[MAX_ROW_COUNT] = {};
+
+    /// <summary>
+    /// Alpha value of the rectangle covering the whole screen.
+    /// </summary>
+    float foregroundAlpha = 0.0f;
+
+    /// <summary>
+    /// Texture of the title.
+    /// </summary>
+    uint32_t titleTexture = 0;
+
+    /// <summary>
+    /// Alpha value of the title.
+    /// </summary>
+    float titleAlpha = 0.0f;
+
+    /// <summary>
+    /// Texture of the subtitle.
+    /// </summary>
+    uint32_t subtitleTexture = 0;
+
+    /// <summary>
+    /// Alpha value of the subtitle.
+    /// </summary>
+    float subtitleAlpha = 0.0f;
+
+    /// <summary>
+    /// Textures of the life count digits on the HUD.
+    /// </summary>
+    uint32_t lifeDigitTextures[LIFE_COUNT_DIGITS] = {};
+
+    /// <summary>
+    /// Textures of the score digits on the HUD.
+    /// </summary>
+    uint32_t scoreDigitTextures[SCORE_COUNT_DIGITS] = {};
+};
+
+/// <summary>
+/// Structure describing the uniform grid the bricks are laid out on. Each cell holds exactly one brick slot, so cells can be mapped directly to brick
+/// indices. Bricks placed off the grid follow the bricks of the grid and are found through BrickColliders::freeBricks instead.
+/// </summary>
+struct BrickGrid {
+    /// <summary>
+    /// Top left corner of the cell at the first row and the first column.
+    /// </summary>
+    glm::vec2 origin = {0.0f, 0.0f};
+
+    /// <summary>
+    /// Dimensions of a single cell, brick dimensions increased by the spacing between the bricks.
+    /// </summary>
+    glm::vec2 cellDimensions = {0.0f, 0.0f};
+
+    /// <summary>
+    /// Number of rows in the grid.
+    /// </summary>
+    uint32_t rowCount = 0;
+
+    /// <summary>
+    /// Number of columns in the grid.
+    /// </summary>
+    uint32_t columnCount = 0;
 };
 
 struct Buffer;
+struct FramePacket;
 class Renderer;
+class SoundManager;
 class TextureManager;
 
 /// <summary>
@@ -106,16 +397,19 @@ class Level {
     /// <param name="levelPath">Full path to the level.</param>
     /// <param name="windowWidth">Width of the main window.</param>
     /// <param name="windowHeight">Height of the main window.</param>
-    /// <param name="renderer">Pointer to the renderer.</param>
-    /// <param name="textureManager">Pointer to the texture manager.</param>
-    Level(const char* levelPath, const uint32_t& windowWidth, const uint32_t& windowHeight, Renderer* const renderer, TextureManager* const textureManager);
+    /// <param name="renderer">Pointer to the renderer, unused in headless builds.</param>
+    /// <param name="textureManager">Pointer to the texture manager, unused in headless builds.</param>
+    /// <param name="soundManager">Pointer to the sound manager, unused in headless builds.</param>
+    Level(const char* levelPath, const uint32_t& windowWidth, const uint32_t& windowHeight, Renderer* const renderer, TextureManager* const textureManager,
+          SoundManager* const soundManager);
 
     /// <summary>
     /// Waits for the GPU to finish all work before allowing automatic destruction of instances buffer that may still be in use."
     ~Level();
 
     /// <summary>
-    /// Copies backup of instances vector to be used, uploads the data to the GPU, sets up command buffers and sets the UI values.
+    /// Copies backup of instances vector to be used and sets the UI values. The GPU is NOT updated, the render thread binds the level with bindRenderData
+    /// once it draws the first frame packet of it.
     /// </summary>
     /// <param name="lifeCount">Number of lives to be displayed on the HUD.</param>
     /// <param name="score">Score to be displayed on the HUD.</param>
@@ -123,9 +417,30 @@ class Level {
     void load(const uint32_t& lifeCount, const uint32_t& score, const uint32_t& levelIndex);
 
     /// <summary>
-    /// Uploads the current state of the instance vector to the GPU. It needs to be called to make any changes applied to the instance vector visible.
+    /// Copies the state of the level in use and the pad and ball positions of the previous simulation step into the frame packet. The packet's level index
+    /// and interpolation are left to the caller.
+    /// </summary>
+    /// <param name="packet">Frame packet to be filled.</param>
+    void captureFramePacket(FramePacket& packet) const;
+
+    /// <summary>
+    /// Resets the instances drawn by the render thread to the backup, uploads them to the GPU and sets up command buffers. Called on the render thread
+    /// whenever it switches to drawing this level.
+    /// </summary>
+    /// <param name="levelNumber">Level ordinal number to be displayed on the HUD.</param>
+    void bindRenderData(const uint32_t& levelNumber);
+
+    /// <summary>
+    /// Applies the frame packet to the instances drawn by the render thread and uploads them to the GPU. Pad and ball are uploaded at positions
+    /// interpolated between the previous and the current simulation step. Called on the render thread only, the level in use is not touched.
+    /// </summary>
+    /// <param name="packet">Frame packet produced from this level.</param>
+    void updateGPUData(const FramePacket& packet);
+
+    /// <summary>
+    /// Stores the current pad and ball positions as the starting point of the render interpolation. Called before each simulation step.
     /// </summary>
-    void updateGPUData() const;
+    void storePreviousPositions();
 
     /// <summary>
     /// Sets the alpha value for the rectangle covering the whole screen, allowing for fade in and fade out effects. The GPU is NOT updated.
@@ -176,7 +491,25 @@ class Level {
     std::vector<Instance>& getInstances();
 
     /// <summary>
-    /// Returns the structure containing static data for the brick type.
+    /// Read-only getter for instance vector currently in use.
+    /// </summary>
+    /// <returns>Currently used instance vector.</returns>
+    const std::vector<Instance>& getInstances() const;
+
+    /// <summary>
+    /// Getter for the fixed point position of the pad center, moved by fixed point physics.
+    /// </summary>
+    /// <returns>Fixed point position of the pad center.</returns>
+    FixedVec2& getFixedPadPosition();
+
+    /// <summary>
+    /// Getter for the fixed point positions of the ball centers, moved by fixed point physics.
+    /// </summary>
+    /// <returns>Fixed point positions of the ball centers, one for each ball.</returns>
+    std::vector<FixedVec2>& getFixedBallPositions();
+
+    /// <summary>
+    /// Returns the structure containing static data for the brick type, indexing the brick type table.
     /// </summary>
     /// <param name="id">The id of the brick info is requested for.</param>
     /// <returns>The BrickType value for the brick with the provided id.</returns>
@@ -194,6 +527,13 @@ class Level {
     /// <returns>The total number of bricks.</returns>
     const uint32_t& getTotalBrickCount() const;
 
+    /// <summary>
+    /// Getter for the number of texture lookups made since the level was built. Lookups build a string key and allocate in the windowed game, headless
+    /// builds count them all the same, so tools can check that steady state play never looks textures up.
+    /// </summary>
+    /// <returns>Number of texture lookups.</returns>
+    const uint64_t& getTextureLookupCount() const;
+
     /// <summary>
     /// Returns the pointer to the instance vector at the index of the first brick.
     /// </summary>
@@ -201,10 +541,39 @@ class Level {
     Instance* const getBricksPtr();
 
     /// <summary>
-    /// Decrements the amount of remaining destructable bricks in the level.
+    /// Returns the grid the bricks are laid out on. Brick at row i and column j is at index i * columnCount + j, bricks placed off the grid start at index
+    /// rowCount * columnCount.
+    /// </summary>
+    /// <returns>The grid the bricks are laid out on.</returns>
+    const BrickGrid& getBrickGrid() const;
+
+    /// <summary>
+    /// Returns the collision data of the bricks.
+    /// </summary>
+    /// <returns>The collision data of the bricks.</returns>
+    const BrickColliders& getBrickColliders() const;
+
+    /// <summary>
+    /// Takes a point of health from the brick, keeping the hash of the brick health up to date. Bricks with infinite health must not be damaged.
+    /// </summary>
+    /// <param name="brickIndex">Index of the damaged brick, relative to the first brick.</param>
+    /// <returns>Health left to the brick.</returns>
+    const uint32_t& damageBrick(const uint32_t& brickIndex);
+
+    /// <summary>
+    /// Clears the brick from the alive masks of the collision data and decrements the amount of remaining destructable bricks in the level.
     /// </summary>
+    /// <param name="brickIndex">Index of the destroyed brick, relative to the first brick.</param>
     /// <returns>Number of remaining destructable bricks in the level.</returns>
-    const uint32_t& destroyBrick();
+    const uint32_t& destroyBrick(const uint32_t& brickIndex);
+
+    /// <summary>
+    /// Starts a simulation step for the moving rows of bricks. The displacement of the previous step is applied to the offsets, and the displacement of
+    /// this step is calculated, turning the rows around at the ends of their ranges. Only the row offsets are updated, the cost does not depend on the
+    /// number of bricks. The offsets are kept in fixed point, so both physics modes move the rows identically on every machine.
+    /// </summary>
+    /// <param name="frameTime">Duration of the simulation step.</param>
+    void moveRows(const uint32_t& frameTime /*microseconds*/);
 
     /// <summary>
     /// Returns the dimensions of the main window.
@@ -213,16 +582,50 @@ class Level {
     const glm::vec2 getWindowDimensions() const;
 
     /// <summary>
-    /// Getter for index of instance that holds ball information.
+    /// Getter for index of instance that holds the first ball information. Instances of the other balls follow it.
     /// </summary>
-    /// <returns>Index of instance that holds ball information.</returns>
+    /// <returns>Index of instance that holds the first ball information.</returns>
     const uint32_t& getBallIndex() const;
 
     /// <summary>
-    /// Calculates the initial direction of the ball based on the pad position in the play area.
+    /// Returns the number of balls in the level, active or not.
+    /// </summary>
+    /// <returns>The number of balls in the level.</returns>
+    const uint32_t& getBallCount() const;
+
+    /// <summary>
+    /// Returns the number of balls still in play.
+    /// </summary>
+    /// <returns>The number of balls still in play.</returns>
+    const uint32_t& getActiveBallCount() const;
+
+    /// <summary>
+    /// Checks whether the ball is still in play.
+    /// </summary>
+    /// <param name="ball">Index of the ball, relative to the first ball.</param>
+    /// <returns>True if the ball is still in play, false otherwise.</returns>
+    const bool isBallActive(const uint32_t& ball) const;
+
+    /// <summary>
+    /// Takes the ball out of play and hides it.
+    /// </summary>
+    /// <param name="ball">Index of the ball, relative to the first ball.</param>
+    void deactivateBall(const uint32_t& ball);
+
+    /// <summary>
+    /// Returns the horizontal offset of the ball from the pad center while the balls are attached to the pad.
+    /// </summary>
+    /// <param name="ball">Index of the ball, relative to the first ball.</param>
+    /// <returns>The horizontal offset of the ball from the pad center.</returns>
+    const float getAttachedBallOffset(const uint32_t& ball) const;
+
+    /// <summary>
+    /// Calculates the initial direction of the ball based on the pad position in the play area. With multiple balls, directions are spread evenly around the
+    /// direction of a single ball.
     /// </summary>
+    /// <param name="ball">Index of the ball, relative to the first ball.</param>
     /// <returns>The initial direction of the ball.</returns>
-    const glm::vec2 getStartingBallDirection() const;
+    const glm::vec2 getStartingBallDirection(const uint32_t& ball = 0) const;
 
     /// <summary>
     /// Returns the base speed of the pad for this level.
@@ -237,10 +640,51 @@ class Level {
     const float& getBaseBallSpeed() const;
 
     /// <summary>
-    /// Resets the pad to the center of the screen and set the ball on top of it.
+    /// Returns the handle of the sound of the ball hitting the pad.
+    /// </summary>
+    /// <returns>Handle of the pad sound.</returns>
+    const uint32_t& getPadSound() const;
+
+    /// <summary>
+    /// Returns the handle of the sound of the ball hitting a wall.
+    /// </summary>
+    /// <returns>Handle of the wall sound.</returns>
+    const uint32_t& getWallSound() const;
+
+    /// <summary>
+    /// Returns the handle of the sound of a lost life.
+    /// </summary>
+    /// <returns>Handle of the lost life sound.</returns>
+    const uint32_t& getLostLifeSound() const;
+
+    /// <summary>
+    /// Resets the pad to the center of the screen and puts all the balls back in play on top of it.
     /// </summary>
     void resetPadAndBall();
 
+    /// <summary>
+    /// Hashes the state of the level in use that physics depends on: the health of the bricks, the pad and ball positions, the balls in play and the
+    /// positions of the moving rows. The bricks are covered by a hash kept up to date as they are damaged, so the cost does not depend on their number.
+    /// </summary>
+    /// <param name="fixedPoint">True to hash the fixed point positions of the pad and the balls, which fixed point physics keeps to more bits than the
+    /// floats drawn from them, false to hash the floats.</param>
+    /// <returns>Hash of the level state.</returns>
+    const uint64_t getStateHash(const bool& fixedPoint) const;
+
+    /// <summary>
+    /// Copies the state of the level in use into the snapshot. Only the state that changes while the level is played is copied, not the whole instance
+    /// vector like on load.
+    /// </summary>
+    /// <param name="snapshot">Snapshot to be filled.</param>
+    void captureSnapshot(LevelSnapshot& snapshot) const;
+
+    /// <summary>
+    /// Puts the level in use back into the state of the snapshot, without allocating. The level has to be loaded, and the snapshot has to be taken from
+    /// this level. The GPU is NOT updated.
+    /// </summary>
+    /// <param name="snapshot">Snapshot taken from this level.</param>
+    void restoreSnapshot(const LevelSnapshot& snapshot);
+
   private:
     /// <summary>
     /// Path to the background texture, relative to the textures folder.
@@ -278,10 +722,15 @@ class Level {
     uint32_t m_columnSpacing;
 
     /// <summary>
-    /// Total number of bricks in the level.
+    /// Total number of bricks in the level, on the grid and off it.
     /// </summary>
     uint32_t m_totalBrickCount;
 
+    /// <summary>
+    /// Grid the bricks are laid out on, used for broadphase collision queries.
+    /// </summary>
+    BrickGrid m_brickGrid;
+
     /// <summary>
     /// Width of the program window.
     /// </summary>
@@ -293,10 +742,15 @@ class Level {
     uint32_t m_windowHeight;
 
     /// <summary>
-    /// Instance index for instance that holds data for the ball.
+    /// Instance index for instance that holds data for the first ball.
     /// </summary>
     uint32_t m_ballIndex;
 
+    /// <summary>
+    /// Number of balls in the level.
+    /// </summary>
+    uint32_t m_ballCount = 1;
+
     /// <summary>
     /// Instance index for instance that holds data for the foreground.
     /// </summary>
@@ -348,10 +802,25 @@ class Level {
     glm::vec2 m_padInitialPosition;
 
     /// <summary>
-    /// Initial position of the ball, on the center of the pad.
+    /// Initial position of the first ball, on the pad.
     /// </summary>
     glm::vec2 m_ballInitialPosition;
 
+    /// <summary>
+    /// Width of the pad area the attached balls are spread over.
+    /// </summary>
+    float m_attachedBallSpread;
+
+    /// <summary>
+    /// Position of the pad before the last simulation step, used for render interpolation.
+    /// </summary>
+    glm::vec2 m_padPreviousPosition;
+
+    /// <summary>
+    /// Positions of the balls before the last simulation step, used for render interpolation.
+    /// </summary>
+    std::vector<glm::vec2> m_ballPreviousPositions;
+
     /// <summary>
     /// Width of the play area (window width reduced by the walls).
     /// </summary>
@@ -372,21 +841,68 @@ class Level {
     /// </summary>
     float m_baseBallSpeed;
 
+    /// <summary>
+    /// Handle of the sound of the ball hitting the pad.
+    /// </summary>
+    uint32_t m_padSound;
+
+    /// <summary>
+    /// Handle of the sound of the ball hitting a wall.
+    /// </summary>
+    uint32_t m_wallSound;
+
+    /// <summary>
+    /// Handle of the sound of a lost life.
+    /// </summary>
+    uint32_t m_lostLifeSound;
+
     /// <summary>
     /// 2D vector of brick ids of the level, in their positions.
     /// </summary>
     std::vector<std::vector<uint32_t>> m_levelLayout;
 
     /// <summary>
-    /// Map of all brick types and their ids.
+    /// Velocities of the rows as declared in the xml, in play area widths per second, 0.0f for static rows.
+    /// </summary>
+    std::vector<float> m_rowVelocityRatios;
+
+    /// <summary>
+    /// Largest distances the rows may move away from their declared positions as declared in the xml, in play area widths.
+    /// </summary>
+    std::vector<float> m_rowRangeRatios;
+
+    /// <summary>
+    /// Bricks placed off the grid as declared in the xml. They follow the bricks of the grid in the instance vector.
+    /// </summary>
+    std::vector<FreeBrick> m_freeBricks;
+
+    /// <summary>
+    /// Table of all brick types, indexed by their ids. Id 0 is the empty cell.
+    /// </summary>
+    std::vector<BrickType> m_brickTypes;
+
+    /// <summary>
+    /// Texture ids of the digits 0 to 9, resolved when the level is built so the HUD numbers are set without looking textures up.
     /// </summary>
-    std::map<uint32_t, BrickType> m_brickTypes;
+    uint32_t m_digitTextureIds[10] = {};
 
+    /// <summary>
+    /// Number of texture lookups made since the level was built.
+    /// </summary>
+    uint64_t m_textureLookupCount = 0;
+
+#ifndef BREAKOUT_HEADLESS
     /// <summary>
     ///  Vulkan buffer holding the data in the instance vector.
     /// </summary>
     std::unique_ptr<Buffer> m_instanceBuffer;
 
+    /// <summary>
+    /// Instances drawn by the render thread, the backup with the state of the latest frame packet applied.
+    /// </summary>
+    std::vector<Instance> m_renderInstances;
+#endif
+
     /// <summary>
     /// Size of instance buffer in bytes.
     /// </summary>
@@ -403,12 +919,34 @@ class Level {
     TextureManager* const m_textureManager;
 
     /// <summary>
-    /// Sets the number on the HUD. Only sets least important digitCount of digits.
+    /// Pointer to global sound manager.
+    /// </summary>
+    SoundManager* const m_soundManager;
+
+    /// <summary>
+    /// Sets the number on the HUD. Only sets least important digitCount of digits. Digit textures are resolved when the level is built, so this never
+    /// allocates.
     /// </summary>
+    /// <param name="instances">Instance vector holding the HUD.</param>
     /// <param name="instanceIndex">Index of the starting number texture in the instance vector.</param>
     /// <param name="digitCount">Number of digits available to display the number.</param>
     /// <param name="number">Value to set the HUD number to.</param>
-    void setNumber(const uint32_t& instanceIndex, const uint32_t& digitCount, uint32_t number);
+    void setNumber(std::vector<Instance>& instances, const uint32_t& instanceIndex, const uint32_t& digitCount, uint32_t number);
+
+    /// <summary>
+    /// Returns the id of the texture from the texture manager and counts the lookup. Headless builds have no textures and always return 0.
+    /// </summary>
+    /// <param name="textureId">Path to the texture relative to the textures folder.</param>
+    /// <param name="scale">Scale of the texture.</param>
+    /// <returns>Id of the requested texture.</returns>
+    const uint32_t getTextureId(const std::string& textureId, const float& scale = 1.0f);
+
+    /// <summary>
+    /// Returns the handle of the sound from the sound manager. Headless builds have no sounds and always return 0.
+    /// </summary>
+    /// <param name="soundId">Path to the sound relative to the sounds folder, empty for no sound.</param>
+    /// <returns>Handle of the requested sound, NO_SOUND for an empty path.</returns>
+    const uint32_t getSoundHandle(const std::string& soundId);
 
     /// <summary>
     /// Loads the xml file containg level data and parses it
@@ -416,8 +954,22 @@ class Level {
     /// <param name="fullLevelPath">Full path to the level xml file.</param>
     void parseXml(const char* fullLevelPath);
 
+    /// <summary>
+    /// Parses a single row of the level layout. Unknown brick names are skipped, and the row is padded with empty cells up to the column count.
+    /// </summary>
+    /// <param name="line">Brick names of the row, separated by spaces.</param>
+    /// <param name="idNameMap">Map of the brick names to the brick type ids.</param>
+    /// <returns>Brick type ids of the row.</returns>
+    std::vector<uint32_t> parseRow(const std::string& line, const std::map<const std::string, uint32_t>& idNameMap) const;
+
     /// <summary>
     /// Generates and populates instance vector based on data parsed from the xml.
     /// </summary>
     void generateRenderData();
+
+    /// <summary>
+    /// Places the fixed point pad and ball positions at the float positions of their instances.
+    /// </summary>
+    /// <param name="data">Level data whose positions are placed.</param>
+    void placeFixedPositions(DynamicLevelData& data);
 };
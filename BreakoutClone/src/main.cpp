@@ -3,14 +3,56 @@
 #include "common.h"
 #include "windows.h"
 
+#include <csignal>
+#include <cstring>
+
 // For some reason, someone thought that line
 // #define main SDL_main
 // was a good idea
 #undef main
 
-int main(int, char*[]) {
+/// <summary>
+/// Asks for the telemetry and the profiler trace to be saved on Ctrl+Break, the game keeps running.
+/// </summary>
+static void onSaveTelemetrySignal(int) {
+    // Handlers are reset to the default one when they are called
+    std::signal(SIGBREAK, onSaveTelemetrySignal);
+    Telemetry::requestSave();
+}
+
+int main(int argc, char* argv[]) {
+    PhysicsMode physicsMode      = PhysicsMode::FLOATING_POINT;
+    const char* inputLogPath     = nullptr;
+    const char* stateHashLogPath = nullptr;
+    const char* telemetryPath    = nullptr;
+    const char* tracePath        = nullptr;
+    bool        autoplay         = false;
+    uint32_t    targetFramerate  = TARGET_FRAMERATE;
+    PacingMode  pacingMode       = PacingMode::FRAME_RATE;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && !strcmp(argv[i], "--record")) {
+            inputLogPath = argv[++i];
+        } else if (i + 1 < argc && !strcmp(argv[i], "--hash-log")) {
+            stateHashLogPath = argv[++i];
+        } else if (i + 1 < argc && !strcmp(argv[i], "--telemetry")) {
+            telemetryPath = argv[++i];
+        } else if (i + 1 < argc && !strcmp(argv[i], "--trace")) {
+            tracePath = argv[++i];
+        } else if (!strcmp(argv[i], "--fixed-point")) {
+            physicsMode = PhysicsMode::FIXED_POINT;
+        } else if (!strcmp(argv[i], "--autoplay")) {
+            autoplay = true;
+        } else if (!strcmp(argv[i], "--uncapped")) {
+            targetFramerate = 0;
+        } else if (!strcmp(argv[i], "--low-latency")) {
+            pacingMode = PacingMode::LATENCY;
+        }
+    }
+
+    std::signal(SIGBREAK, onSaveTelemetrySignal);
+
     try {
-        Breakout breakout;
+        Breakout breakout(physicsMode, inputLogPath, stateHashLogPath, telemetryPath, tracePath, autoplay, targetFramerate, pacingMode);
         breakout.run();
     } catch (std::runtime_error e) {
         MessageBoxA(NULL, e.what(), NULL, MB_ICONERROR | MB_OK);
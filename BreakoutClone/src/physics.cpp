@@ -1,56 +1,379 @@
 #include "physics.h"
 #include "level.h"
+#include "profiler.h"
 
 #include <algorithm>
+#include <cmath>
 
 #define CROSS2D(first, second) ((first).x * (second).y - (first).y * (second).x)
 #define SIGNUM(x)              ((x > 0.0) - (x < 0.0))
 
+static_assert(COLLISION_EVENT_CAPACITY >= MAX_BALL_COUNT * (MAX_BALL_SUB_STEPS + 1), "A simulation step must not drop collision events!");
+
+// Batched brick tests use the widest vector instructions the build targets, define PHYSICS_NO_SIMD to force the scalar fallback
+#if !defined(PHYSICS_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define PHYSICS_BATCH_WIDTH 8
+#define BATCH_FLOAT         __m256
+#define BATCH_SET1          _mm256_set1_ps
+#define BATCH_LOAD          _mm256_loadu_ps
+#define BATCH_STORE         _mm256_storeu_ps
+#define BATCH_ADD           _mm256_add_ps
+#define BATCH_SUB           _mm256_sub_ps
+#define BATCH_MUL           _mm256_mul_ps
+#define BATCH_DIV           _mm256_div_ps
+#define BATCH_SQRT          _mm256_sqrt_ps
+#define BATCH_MIN           _mm256_min_ps
+#define BATCH_MAX           _mm256_max_ps
+#define BATCH_AND           _mm256_and_ps
+#define BATCH_ANDNOT        _mm256_andnot_ps
+#define BATCH_OR            _mm256_or_ps
+#define BATCH_XOR           _mm256_xor_ps
+#define BATCH_LT(a, b)      _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define BATCH_LE(a, b)      _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define BATCH_GT(a, b)      _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define BATCH_GE(a, b)      _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define BATCH_NEQ(a, b)     _mm256_cmp_ps(a, b, _CMP_NEQ_UQ)
+#define BATCH_MOVEMASK      _mm256_movemask_ps
+#elif !defined(PHYSICS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PHYSICS_BATCH_WIDTH 4
+#define BATCH_FLOAT         __m128
+#define BATCH_SET1          _mm_set1_ps
+#define BATCH_LOAD          _mm_loadu_ps
+#define BATCH_STORE         _mm_storeu_ps
+#define BATCH_ADD           _mm_add_ps
+#define BATCH_SUB           _mm_sub_ps
+#define BATCH_MUL           _mm_mul_ps
+#define BATCH_DIV           _mm_div_ps
+#define BATCH_SQRT          _mm_sqrt_ps
+#define BATCH_MIN           _mm_min_ps
+#define BATCH_MAX           _mm_max_ps
+#define BATCH_AND           _mm_and_ps
+#define BATCH_ANDNOT        _mm_andnot_ps
+#define BATCH_OR            _mm_or_ps
+#define BATCH_XOR           _mm_xor_ps
+#define BATCH_LT            _mm_cmplt_ps
+#define BATCH_LE            _mm_cmple_ps
+#define BATCH_GT            _mm_cmpgt_ps
+#define BATCH_GE            _mm_cmpge_ps
+#define BATCH_NEQ           _mm_cmpneq_ps
+#define BATCH_MOVEMASK      _mm_movemask_ps
+#else
+#define PHYSICS_BATCH_WIDTH 4
+#endif
+
+#define PHYSICS_BATCH_MASK ((1ull << PHYSICS_BATCH_WIDTH) - 1)
+
+#define FIXED_EPSILON static_cast<Fixed>(EPSILON * FIXED_ONE)
+
+// Mask with the bits from first to last, inclusive
+#define BIT_RANGE(first, last) ((~0ull >> (63 - (last))) & (~0ull << (first)))
+
+static_assert(PHYSICS_BATCH_WIDTH <= COLLIDER_PADDING, "Brick collider arrays must be padded for a full batch load past the last brick.");
+static_assert(MAX_ROW_COUNT <= 64 && MAX_COLUMN_COUNT <= 64, "Brick rows and columns must fit into 64 bit alive masks.");
+
+#ifdef BATCH_FLOAT
+// Lane-wise version of raySlabIntersection. The velocity is shared by all lanes, so the near and far planes are picked once, lanes outside a slab the
+// ray runs parallel to are added to missed
+#define BATCH_RAY_SLAB(start, velocity, slabMin, slabMax, nearT, farT, missed)                                                                              \
+    {                                                                                                                                                          \
+        if (velocity == 0.0f) {                                                                                                                                \
+            nearT  = BATCH_SET1(-INFINITY);                                                                                                                    \
+            farT   = BATCH_SET1(INFINITY);                                                                                                                     \
+            missed = BATCH_OR(missed, BATCH_OR(BATCH_LT(start, slabMin), BATCH_GT(start, slabMax)));                                                         \
+        } else {                                                                                                                                               \
+            BATCH_FLOAT inverseVelocity = BATCH_SET1(1.0f / velocity);                                                                                        \
+            nearT                       = BATCH_MUL(BATCH_SUB(velocity > 0.0f ? slabMin : slabMax, start), inverseVelocity);                                 \
+            farT                        = BATCH_MUL(BATCH_SUB(velocity > 0.0f ? slabMax : slabMin, start), inverseVelocity);                                 \
+        }                                                                                                                                                      \
+    }
+
+// Lane-wise version of segmentCircleCollisionStatic, with the operations in the same order so the results are identical
+#define BATCH_SEGMENT_CIRCLE(startX, startY, directionX, directionY, circleX, circleY, t, hit)                                                                \
+    {                                                                                                                                                          \
+        BATCH_FLOAT fX           = BATCH_SUB(startX, circleX);                                                                                                \
+        BATCH_FLOAT fY           = BATCH_SUB(startY, circleY);                                                                                                \
+        BATCH_FLOAT b            = BATCH_MUL(two, BATCH_ADD(BATCH_MUL(fX, directionX), BATCH_MUL(fY, directionY)));                                          \
+        BATCH_FLOAT c            = BATCH_SUB(BATCH_ADD(BATCH_MUL(fX, fX), BATCH_MUL(fY, fY)), radiusSquared);                                                \
+        BATCH_FLOAT discriminant = BATCH_SUB(BATCH_MUL(b, b), BATCH_MUL(fourA, c));                                                                           \
+        hit                      = BATCH_GE(discriminant, zero);                                                                                              \
+        t                        = BATCH_DIV(BATCH_SUB(BATCH_XOR(b, signMask), BATCH_SQRT(BATCH_AND(discriminant, hit))), twoA);                             \
+        hit                      = BATCH_AND(hit, BATCH_AND(BATCH_GE(t, zero), BATCH_LE(t, one)));                                                            \
+    }
+
+// Picks lanes of first where mask is set and lanes of second elsewhere
+#define BATCH_SELECT(mask, first, second) BATCH_OR(BATCH_AND(mask, first), BATCH_ANDNOT(mask, second))
+#endif
+
+Physics::Physics(const PhysicsMode& mode) : m_mode(mode) { m_ballCells.reserve(MAX_BALL_COUNT); }
+
 LevelState Physics::resolveFrame(const uint32_t& frameTime /*microseconds*/, Level& level, const float& ballSpeedModifier /*pixels per microsecond*/,
-                                 const float& padSpeedModifier /*pixels per microsecond*/, glm::vec2& ballDirection,
-                                 std::vector<CollisionData>& collisionInfo) {
+                                 const float& padSpeedModifier /*pixels per microsecond*/, std::vector<glm::vec2>& ballDirections,
+                                 CollisionEventRing& collisionEvents) {
+    PROFILE_ZONE("Physics::resolveFrame");
+
+    ++m_subStepStatistics.frameCount;
+    m_subStepStatistics.lastFrameSubStepCount = 0;
+
+    level.moveRows(frameTime);
+
+    if (m_mode == PhysicsMode::FIXED_POINT) {
+        return resolveFrameFixed(frameTime, level, ballSpeedModifier, padSpeedModifier, ballDirections, collisionEvents);
+    }
+
     std::vector<Instance>& instances = level.getInstances();
 
-    glm::vec2& ballPosition = instances[level.getBallIndex()].position;
-    glm::vec2& ballScale    = instances[level.getBallIndex()].scale;
-    glm::vec2& padPosition  = instances[PAD_INDEX].position;
-    glm::vec2& padScale     = instances[PAD_INDEX].scale;
+    const uint32_t& firstBallIndex = level.getBallIndex();
+    const uint32_t& ballCount      = level.getBallCount();
+    glm::vec2&      ballScale      = instances[firstBallIndex].scale;
+    glm::vec2&      padPosition    = instances[PAD_INDEX].position;
+    glm::vec2&      padScale       = instances[PAD_INDEX].scale;
 
     Instance& leftWall  = instances[LEFT_WALL_INDEX];
     Instance& rightWall = instances[RIGHT_WALL_INDEX];
 
-    Instance* bricks = instances.data() + BRICK_START_INDEX;
-
     float leftWallEdge  = leftWall.position.x + leftWall.scale.x * 0.5f;
     float rightWallEdge = rightWall.position.x - rightWall.scale.x * 0.5f;
-    float ballRadius    = ballScale.x * 0.5f;
 
-    float padSpeed = level.getBasePadSpeed() * padSpeedModifier;
+    float padSpeed  = level.getBasePadSpeed() * padSpeedModifier;
+    float ballSpeed = level.getBaseBallSpeed() * ballSpeedModifier;
 
-    // Move the pad as much as the ball and walls allow
+    // Move the pad as much as the walls allow, stopping it just short of where it first touches a ball in its way. The pad only moves sideways, so only
+    // the balls level with it and ahead of it can stop it, once the gap between their boxes closes at their relative sideways speed
     if (padSpeed != 0.0) {
-        float paddP = padSpeed * frameTime;
-        float t;
-        bool  padOutsideBall = (padScale.y * 0.5f + ballScale.y * 0.5f < std::abs(padPosition.y - ballPosition.y)) ||
-                              (padScale.x * 0.5f + ballScale.x * 0.5f < std::abs(padPosition.x - ballPosition.x));
-        glm::vec2 dummy;
-        if (padOutsideBall && !rectRectCollisionDynamic(padPosition, padScale, {SIGNUM(paddP), 0.0f}, std::abs(paddP), ballPosition, ballScale, t, dummy)) {
-            float mostLeft  = leftWallEdge + padScale.x * 0.5f;
-            float mostRight = rightWallEdge - padScale.x * 0.5f;
+        float mostLeft  = leftWallEdge + padScale.x * 0.5f;
+        float mostRight = rightWallEdge - padScale.x * 0.5f;
+        float padTravel = std::clamp(padPosition.x + padSpeed * frameTime, mostLeft, mostRight) - padPosition.x;
+        for (uint32_t ball = 0; ball < ballCount; ++ball) {
+            if (!level.isBallActive(ball)) {
+                continue;
+            }
+
+            glm::vec2 offset = instances[firstBallIndex + ball].position - padPosition;
+            glm::vec2 reach  = (padScale + ballScale) * 0.5f;
+            if (std::abs(offset.y) >= reach.y || offset.x * padTravel <= 0.0f) {
+                continue;
+            }
+
+            // Balls moving away at least as fast as the pad are never caught up with
+            float closingSpeed = (padTravel > 0.0f ? 1.0f : -1.0f) * (padSpeed - ballSpeed * ballDirections[ball].x);
+            if (closingSpeed <= 0.0f) {
+                continue;
+            }
 
-            padPosition.x = std::clamp(padPosition.x + paddP, mostLeft, mostRight);
+            float gap           = std::max(std::abs(offset.x) - reach.x - EPSILON, 0.0f);
+            float contactTravel = std::abs(padSpeed) * gap / closingSpeed;
+            padTravel           = std::clamp(padTravel, -contactTravel, contactTravel);
         }
-    }
 
-    float ballSpeed = level.getBaseBallSpeed() * ballSpeedModifier;
+        padPosition.x += padTravel;
+    }
 
     if (ballSpeed == 0.0f) {
-        ballPosition.x = padPosition.x;
+        for (uint32_t ball = 0; ball < ballCount; ++ball) {
+            instances[firstBallIndex + ball].position.x = padPosition.x + level.getAttachedBallOffset(ball);
+        }
+        return LevelState::STILL_ALIVE;
+    }
+
+    // The first sweeps of all balls are boxed with the same expressions resolveBall uses, so their cells are found in one pass before any ball moves
+    float ballRadius = ballScale.x * 0.5f;
+    m_ballCells.resize(ballCount);
+    for (uint32_t ball = 0; ball < ballCount; ++ball) {
+        glm::vec2& ballPosition   = instances[firstBallIndex + ball].position;
+        glm::vec2  ballTravelPath = ballDirections[ball] * (ballSpeed * frameTime);
+        m_ballCells[ball].sweepMin = glm::min(ballPosition, ballPosition + ballTravelPath) - ballRadius;
+        m_ballCells[ball].sweepMax = glm::max(ballPosition, ballPosition + ballTravelPath) + ballRadius;
+    }
+    findBallCells(level);
+
+    // Every ball is swept on its own, looking up the bricks in the cells found for it
+    for (uint32_t ball = 0; ball < ballCount; ++ball) {
+        if (level.isBallActive(ball) && !resolveBall(level, ball, ballSpeed * frameTime, ballDirections[ball], collisionEvents)) {
+            level.deactivateBall(ball);
+            collisionEvents.push({CollisionType::BALL_LOST, 0, 0, ball});
+        }
+    }
+
+    return level.getActiveBallCount() == 0 ? LevelState::LOST : LevelState::STILL_ALIVE;
+}
+
+const float Physics::predictBallLanding(const Level& level, const uint32_t& ball, const glm::vec2& ballDirection) {
+    const std::vector<Instance>& instances = level.getInstances();
+
+    const glm::vec2& padPosition = instances[PAD_INDEX].position;
+    const glm::vec2& padScale    = instances[PAD_INDEX].scale;
+    const Instance&  leftWall    = instances[LEFT_WALL_INDEX];
+    const Instance&  rightWall   = instances[RIGHT_WALL_INDEX];
+    const float      ballRadius  = instances[level.getBallIndex() + ball].scale.x * 0.5f;
+
+    // Same box resolveBall bounces the ball center in, only with the bottom raised to where the ball touches the pad top
+    glm::vec2 wallBoxMin = {leftWall.position.x + leftWall.scale.x * 0.5f + ballRadius, ballRadius};
+    glm::vec2 wallBoxMax = {rightWall.position.x - rightWall.scale.x * 0.5f - ballRadius, padPosition.y - padScale.y * 0.5f - ballRadius};
+
+    glm::vec2 position  = glm::clamp(instances[level.getBallIndex() + ball].position, wallBoxMin, wallBoxMax);
+    glm::vec2 direction = ballDirection;
+    if (position.y >= wallBoxMax.y || direction.y == 0.0f) {
+        return position.x;
+    }
+
+    // Long enough for a ray in any direction to cross the box, so every cast reaches a wall
+    const float castDistance = 2.0f * (wallBoxMax.x - wallBoxMin.x + wallBoxMax.y - wallBoxMin.y);
+    for (uint32_t bounce = 0; bounce < MAX_BALL_SUB_STEPS; ++bounce) {
+        glm::vec2 castPath = direction * castDistance;
+        float     t;
+        bool      sideWall;
+        if (!wallBoxCollision(position, castPath, wallBoxMin, wallBoxMax, t, sideWall)) {
+            break;
+        }
+
+        position += castPath * t;
+        if (!sideWall && direction.y > 0.0f) {
+            break;
+        }
+        direction = sideWall ? glm::vec2(-direction.x, direction.y) : glm::vec2(direction.x, -direction.y);
+    }
+
+    return position.x;
+}
+
+const PhysicsMode& Physics::getMode() const { return m_mode; }
+
+const SubStepStatistics& Physics::getSubStepStatistics() const { return m_subStepStatistics; }
+
+void Physics::resetSubStepStatistics() { m_subStepStatistics = SubStepStatistics(); }
+
+void Physics::countSubSteps(const uint32_t& subStepCount, const bool& budgetReached) {
+    ++m_subStepStatistics.ballFrameCount;
+    m_subStepStatistics.subStepCount += subStepCount;
+    m_subStepStatistics.lastFrameSubStepCount += subStepCount;
+    m_subStepStatistics.maxBallSubStepCount = std::max(m_subStepStatistics.maxBallSubStepCount, subStepCount);
+    m_subStepStatistics.budgetReachedCount += budgetReached;
+}
+
+LevelState Physics::resolveFrameFixed(const uint32_t& frameTime /*microseconds*/, Level& level, const float& ballSpeedModifier /*pixels per microsecond*/,
+                                      const float& padSpeedModifier /*pixels per microsecond*/, std::vector<glm::vec2>& ballDirections,
+                                      CollisionEventRing& collisionEvents) {
+    std::vector<Instance>&  instances     = level.getInstances();
+    std::vector<FixedVec2>& ballPositions = level.getFixedBallPositions();
+    FixedVec2&              padPosition   = level.getFixedPadPosition();
+
+    const uint32_t& firstBallIndex = level.getBallIndex();
+    const uint32_t& ballCount      = level.getBallCount();
+    FixedVec2       ballHalfScale  = {toFixed(instances[firstBallIndex].scale.x) / 2, toFixed(instances[firstBallIndex].scale.y) / 2};
+    FixedVec2       padHalfScale   = {toFixed(instances[PAD_INDEX].scale.x) / 2, toFixed(instances[PAD_INDEX].scale.y) / 2};
+
+    Instance& leftWall  = instances[LEFT_WALL_INDEX];
+    Instance& rightWall = instances[RIGHT_WALL_INDEX];
+
+    Fixed leftWallEdge  = toFixed(leftWall.position.x) + toFixed(leftWall.scale.x) / 2;
+    Fixed rightWallEdge = toFixed(rightWall.position.x) - toFixed(rightWall.scale.x) / 2;
+
+    Fixed padSpeed   = fixedMultiply(toFixedSpeed(level.getBasePadSpeed()), toFixed(padSpeedModifier));
+    Fixed ballSpeed  = fixedMultiply(toFixedSpeed(level.getBaseBallSpeed()), toFixed(ballSpeedModifier));
+    Fixed paddP      = fixedTravel(padSpeed, frameTime);
+    Fixed ballTravel = fixedTravel(ballSpeed, frameTime);
+
+    // Move the pad as much as the walls allow, stopping it just short of where it first touches a ball in its way, the same way as the floating point
+    // resolver
+    if (paddP != 0) {
+        Fixed mostLeft  = leftWallEdge + padHalfScale.x;
+        Fixed mostRight = rightWallEdge - padHalfScale.x;
+        Fixed padTravel = std::clamp(padPosition.x + paddP, mostLeft, mostRight) - padPosition.x;
+        for (uint32_t ball = 0; ball < ballCount; ++ball) {
+            if (!level.isBallActive(ball)) {
+                continue;
+            }
+
+            const FixedVec2& ballPosition = ballPositions[ball];
+            Fixed            offsetX      = ballPosition.x - padPosition.x;
+            if (std::abs(ballPosition.y - padPosition.y) >= padHalfScale.y + ballHalfScale.y || (offsetX > 0) != (padTravel > 0) || offsetX == 0) {
+                continue;
+            }
+
+            Fixed closingSpeed = (padTravel > 0 ? 1 : -1) * (padSpeed - fixedMultiply(ballSpeed, toFixed(ballDirections[ball].x)));
+            if (closingSpeed <= 0) {
+                continue;
+            }
+
+            Fixed gap           = std::max(std::abs(offsetX) - padHalfScale.x - ballHalfScale.x - FIXED_EPSILON, static_cast<Fixed>(0));
+            Fixed contactTravel = std::abs(padSpeed) * gap / closingSpeed;
+            padTravel           = std::clamp(padTravel, -contactTravel, contactTravel);
+        }
+
+        padPosition.x += padTravel;
+        instances[PAD_INDEX].position.x = toFloat(padPosition.x);
+    }
+
+    if (ballTravel == 0) {
+        for (uint32_t ball = 0; ball < ballCount; ++ball) {
+            ballPositions[ball].x                       = padPosition.x + toFixed(level.getAttachedBallOffset(ball));
+            instances[firstBallIndex + ball].position.x = toFloat(ballPositions[ball].x);
+        }
         return LevelState::STILL_ALIVE;
     }
 
-    float remainingTravelDistance = ballSpeed * frameTime;
-    while (remainingTravelDistance > 0.0f) {
+    // First sweeps of all balls are boxed the same way as in resolveBallFixed and their cells found in one pass, as in the floating point resolver
+    m_ballCells.resize(ballCount);
+    for (uint32_t ball = 0; ball < ballCount; ++ball) {
+        const FixedVec2& ballPosition  = ballPositions[ball];
+        FixedVec2        ballDirection = toFixed(ballDirections[ball]);
+        FixedVec2 sweepEnd      = {ballPosition.x + fixedMultiply(ballDirection.x, ballTravel), ballPosition.y + fixedMultiply(ballDirection.y, ballTravel)};
+        m_ballCells[ball].sweepMin =
+            toFloat(FixedVec2{std::min(ballPosition.x, sweepEnd.x) - ballHalfScale.x, std::min(ballPosition.y, sweepEnd.y) - ballHalfScale.x});
+        m_ballCells[ball].sweepMax =
+            toFloat(FixedVec2{std::max(ballPosition.x, sweepEnd.x) + ballHalfScale.x, std::max(ballPosition.y, sweepEnd.y) + ballHalfScale.x});
+    }
+    findBallCells(level);
+
+    for (uint32_t ball = 0; ball < ballCount; ++ball) {
+        if (!level.isBallActive(ball)) {
+            continue;
+        }
+
+        // Unit direction components survive the round trip through float exactly, positions are only written to the instances for drawing
+        FixedVec2 ballDirection = toFixed(ballDirections[ball]);
+        bool      ballInPlay    = resolveBallFixed(level, ball, ballTravel, ballPositions[ball], ballDirection, collisionEvents);
+
+        instances[firstBallIndex + ball].position = toFloat(ballPositions[ball]);
+        ballDirections[ball]                      = toFloat(ballDirection);
+
+        if (!ballInPlay) {
+            level.deactivateBall(ball);
+            collisionEvents.push({CollisionType::BALL_LOST, 0, 0, ball});
+        }
+    }
+
+    return level.getActiveBallCount() == 0 ? LevelState::LOST : LevelState::STILL_ALIVE;
+}
+
+bool Physics::resolveBall(Level& level, const uint32_t& ball, const float& travelDistance, glm::vec2& ballDirection,
+                          CollisionEventRing& collisionEvents) {
+    std::vector<Instance>& instances = level.getInstances();
+
+    glm::vec2& ballPosition = instances[level.getBallIndex() + ball].position;
+    glm::vec2& ballScale    = instances[level.getBallIndex() + ball].scale;
+    glm::vec2& padPosition  = instances[PAD_INDEX].position;
+    glm::vec2& padScale     = instances[PAD_INDEX].scale;
+
+    Instance& leftWall  = instances[LEFT_WALL_INDEX];
+    Instance& rightWall = instances[RIGHT_WALL_INDEX];
+
+    const BrickColliders& bricks    = level.getBrickColliders();
+    const BrickGrid&      brickGrid = level.getBrickGrid();
+
+    float leftWallEdge  = leftWall.position.x + leftWall.scale.x * 0.5f;
+    float rightWallEdge = rightWall.position.x - rightWall.scale.x * 0.5f;
+    float ballRadius    = ballScale.x * 0.5f;
+
+    // Box the center of the ball stays in while it touches none of the walls, the bottom one lying below the screen
+    glm::vec2 wallBoxMin = {leftWallEdge + ballRadius, ballRadius};
+    glm::vec2 wallBoxMax = {rightWallEdge - ballRadius, level.getWindowDimensions().y + ballRadius};
+
+    float    remainingTravelDistance = travelDistance;
+    uint32_t subStepCount            = 0;
+    for (; remainingTravelDistance > 0.0f && subStepCount < MAX_BALL_SUB_STEPS; ++subStepCount) {
         CollisionData collisionData;
         float         minimalT                    = 2.0f;
         glm::vec2     reflectedDirectionOfClosest = ballDirection; // If no redirection is triggered
@@ -59,110 +382,579 @@ LevelState Physics::resolveFrame(const uint32_t& frameTime /*microseconds*/, Lev
         float t;
 
         // The walls
-        glm::vec2 windowDimensions = level.getWindowDimensions();
-        float     left             = leftWallEdge + ballRadius;
-        float     right            = rightWallEdge - ballRadius;
-        float     top              = ballRadius;
-        float     bottom           = windowDimensions.y + ballRadius;
+        bool sideWall;
+        if (wallBoxCollision(ballPosition, ballTravelPath, wallBoxMin, wallBoxMax, t, sideWall)) {
+            // Bottom wall
+            if (!sideWall && ballTravelPath.y > 0.0f) {
+                countSubSteps(subStepCount + 1, false);
+                return false;
+            }
+
+            minimalT                    = t;
+            reflectedDirectionOfClosest = sideWall ? glm::vec2(-ballDirection.x, ballDirection.y) : glm::vec2(ballDirection.x, -ballDirection.y);
+            collisionData.type          = CollisionType::WALL;
+        }
+
+        // The pad
+        glm::vec2 latestReflectedDirection;
+        if (rectRectCollisionDynamic(ballPosition, ballScale, ballDirection, remainingTravelDistance, padPosition, padScale, t, latestReflectedDirection)) {
+            if (t < minimalT) {
+                minimalT           = t;
+                collisionData.type = CollisionType::PAD;
+                if (ballDirection.y == -latestReflectedDirection.y) {
+                    float collisionPoint        = (ballPosition + ballTravelPath * (ballRadius + t)).x;
+                    float padLeftCorner         = padPosition.x - 0.5f * padScale.x + ballRadius;
+                    float hitScale              = (collisionPoint - padLeftCorner) / (padScale.x - 2.0f * ballRadius);
+                    hitScale                    = hitScale * 2.0f - 1.0f;
+                    reflectedDirectionOfClosest = glm::normalize(glm::vec2(hitScale * 1.0f, -1.0f));
+                } else {
+                    reflectedDirectionOfClosest = latestReflectedDirection;
+                }
+            }
+        }
+
+        // The bricks, only the ones in the grid cells overlapped by the bounding box of the ball sweep, tested a batch at a time. Moving rows are swept in
+        // their own frame of reference, where the ball travels the path relative to the row
+        uint32_t  hitBrickIndex     = UINT32_MAX;
+        glm::vec2 hitSweepStart     = ballPosition;
+        glm::vec2 hitSweepDirection = ballDirection;
+        float     hitSweepDistance  = remainingTravelDistance;
+        glm::vec2 hitRowPath        = {0.0f, 0.0f};
+        glm::vec2 sweepMin          = glm::min(ballPosition, ballPosition + ballTravelPath) - ballRadius;
+        glm::vec2 sweepMax          = glm::max(ballPosition, ballPosition + ballTravelPath) + ballRadius;
+        uint64_t  rows, columnsInPath;
+        if (getSweepCells(brickGrid, ball, sweepMin, sweepMax, rows, columnsInPath)) {
+            // Only rows and columns with bricks still alive are visited, each batch starts at the next alive brick
+            float remainingFraction = remainingTravelDistance / travelDistance;
+            rows &= bricks.aliveRows;
+            while (rows != 0) {
+                uint32_t row = countTrailingZeros(rows);
+                rows &= rows - 1;
+
+                glm::vec2 sweepStart     = ballPosition;
+                glm::vec2 sweepDirection = ballDirection;
+                float     sweepDistance  = remainingTravelDistance;
+                glm::vec2 rowPath        = {0.0f, 0.0f};
+                uint64_t  columns        = bricks.aliveColumns[row] & columnsInPath;
+                if (bricks.movingRows & (1ull << row)) {
+                    float displacement = toFloat(bricks.rowDisplacements[row]);
+                    rowPath            = {displacement * remainingFraction, 0.0f};
+
+                    glm::vec2 relativePath = ballTravelPath - rowPath;
+                    sweepDistance          = glm::length(relativePath);
+                    if (sweepDistance == 0.0f) {
+                        continue;
+                    }
+                    sweepDirection = relativePath / sweepDistance;
+                    sweepStart     = {ballPosition.x - (toFloat(bricks.rowOffsets[row]) + displacement - rowPath.x), ballPosition.y};
+
+                    uint32_t rowFirstColumn, rowLastColumn;
+                    if (!getOverlappedColumns(brickGrid, std::min(sweepStart.x, sweepStart.x + relativePath.x) - ballRadius,
+                                              std::max(sweepStart.x, sweepStart.x + relativePath.x) + ballRadius, rowFirstColumn, rowLastColumn)) {
+                        continue;
+                    }
+                    columns = bricks.aliveColumns[row] & BIT_RANGE(rowFirstColumn, rowLastColumn);
+                }
+
+                while (columns != 0) {
+                    uint32_t column     = countTrailingZeros(columns);
+                    uint32_t laneMask   = static_cast<uint32_t>((columns >> column) & PHYSICS_BATCH_MASK);
+                    uint32_t firstBrick = row * brickGrid.columnCount + column;
+                    columns &= ~(PHYSICS_BATCH_MASK << column);
+
+                    uint32_t batchHit = circleRectCollisionBatch(sweepStart, ballRadius, sweepDirection, sweepDistance, bricks, firstBrick, laneMask, t);
+                    if (batchHit != UINT32_MAX && t < minimalT) {
+                        minimalT           = t;
+                        hitBrickIndex      = batchHit;
+                        hitSweepStart      = sweepStart;
+                        hitSweepDirection  = sweepDirection;
+                        hitSweepDistance   = sweepDistance;
+                        hitRowPath         = rowPath;
+                        collisionData.type = CollisionType::BRICK;
+                    }
+                }
+            }
+        }
+
+        // Bricks off the grid, found through the spatial hash and tested one at a time
+        bricks.freeBricks.query(sweepMin - EPSILON, sweepMax + EPSILON, [&](const uint32_t& brick) {
+            float     brickT = 2.0f;
+            glm::vec2 brickReflectedDirection;
+            if (circleRectCollisionDynamic(ballPosition, ballRadius, ballDirection, remainingTravelDistance, {bricks.x[brick], bricks.y[brick]},
+                                           {2.0f * bricks.halfWidth[brick], 2.0f * bricks.halfHeight[brick]}, brickT, brickReflectedDirection) &&
+                brickT < minimalT) {
+                minimalT           = brickT;
+                hitBrickIndex      = brick;
+                hitSweepStart      = ballPosition;
+                hitSweepDirection  = ballDirection;
+                hitSweepDistance   = remainingTravelDistance;
+                hitRowPath         = {0.0f, 0.0f};
+                collisionData.type = CollisionType::BRICK;
+            }
+        });
+
+        // Only the closest brick needs the reflected direction, the scalar test finds the same collision as the batched one
+        if (collisionData.type == CollisionType::BRICK) {
+            glm::vec2 brickCenter     = {bricks.x[hitBrickIndex], bricks.y[hitBrickIndex]};
+            glm::vec2 brickDimensions = {2.0f * bricks.halfWidth[hitBrickIndex], 2.0f * bricks.halfHeight[hitBrickIndex]};
+            circleRectCollisionDynamic(hitSweepStart, ballRadius, hitSweepDirection, hitSweepDistance, brickCenter, brickDimensions, t,
+                                       reflectedDirectionOfClosest);
+
+            // A moving brick carries the ball along, the path reflected relative to the row is turned back into a direction in the play area
+            if (hitRowPath.x != 0.0f) {
+                reflectedDirectionOfClosest = glm::normalize(reflectedDirectionOfClosest * hitSweepDistance + hitRowPath);
+            }
+        }
+
+        minimalT = minimalT < 1.0f ? minimalT : 1.0f;
 
-        glm::vec2 topLeftCorner     = {left, top};
-        glm::vec2 topRightCorner    = {right, top};
-        glm::vec2 bottomLeftCorner  = {left, bottom};
-        glm::vec2 bottomRightCorner = {right, bottom};
+        // If anything is hit
+        if (ballDirection != reflectedDirectionOfClosest) {
+            minimalT -= EPSILON;
+            ballDirection = reflectedDirectionOfClosest;
+        }
+
+        ballPosition += ballTravelPath * minimalT;
+        float distanceTraveled = remainingTravelDistance * minimalT;
+        remainingTravelDistance -= distanceTraveled;
+
+        if (collisionData.type == CollisionType::BRICK) {
+            collisionData.hitBrickIndex = hitBrickIndex;
+            collisionData.brickTypeId   = instances[BRICK_START_INDEX + hitBrickIndex].id;
+        }
+
+        if (collisionData.type != CollisionType::NONE) {
+            collisionData.ballIndex = ball;
+            collisionEvents.push(collisionData);
+        }
+    }
+
+    // Out of sub-steps, the ball is most likely pinched between colliders. It waits for the next frame, and is kept inside the walls in case the last
+    // sub-step carried it through one
+    bool budgetReached = remainingTravelDistance > 0.0f;
+    if (budgetReached) {
+        ballPosition.x = std::clamp(ballPosition.x, wallBoxMin.x, wallBoxMax.x);
+        ballPosition.y = std::max(ballPosition.y, wallBoxMin.y);
+    }
+    countSubSteps(subStepCount, budgetReached);
+
+    return true;
+}
+
+bool Physics::resolveBallFixed(Level& level, const uint32_t& ball, const Fixed& travelDistance, FixedVec2& ballPosition, FixedVec2& ballDirection,
+                               CollisionEventRing& collisionEvents) {
+    std::vector<Instance>& instances = level.getInstances();
+
+    Instance& leftWall  = instances[LEFT_WALL_INDEX];
+    Instance& rightWall = instances[RIGHT_WALL_INDEX];
+
+    const BrickColliders& bricks    = level.getBrickColliders();
+    const BrickGrid&      brickGrid = level.getBrickGrid();
+
+    glm::vec2& ballScale     = instances[level.getBallIndex() + ball].scale;
+    FixedVec2  ballHalfScale = {toFixed(ballScale.x) / 2, toFixed(ballScale.y) / 2};
+    FixedVec2& padPosition   = level.getFixedPadPosition();
+    FixedVec2  padHalfScale  = {toFixed(instances[PAD_INDEX].scale.x) / 2, toFixed(instances[PAD_INDEX].scale.y) / 2};
+    Fixed      ballRadius    = ballHalfScale.x;
+
+    // The walls
+    Fixed left   = toFixed(leftWall.position.x) + toFixed(leftWall.scale.x) / 2 + ballRadius;
+    Fixed right  = toFixed(rightWall.position.x) - toFixed(rightWall.scale.x) / 2 - ballRadius;
+    Fixed top    = ballRadius;
+    Fixed bottom = toFixed(level.getWindowDimensions().y) + ballRadius;
+
+    Fixed    remainingTravelDistance = travelDistance;
+    uint32_t subStepCount            = 0;
+    for (; remainingTravelDistance > 0 && subStepCount < MAX_BALL_SUB_STEPS; ++subStepCount) {
+        CollisionData collisionData;
+        Fixed         minimalDistance             = INT64_MAX;
+        FixedVec2     reflectedDirectionOfClosest = ballDirection; // If no redirection is triggered
+        FixedVec2     latestReflectedDirection;
+
+        Fixed distance;
 
         // Bottom wall
-        if (segmentSegmentCollisionStatic(ballPosition, ballTravelPath, bottomLeftCorner, bottomRightCorner - bottomLeftCorner, t)) {
-            return LevelState::LOST;
+        if (raySegmentCollisionFixed(ballPosition.y, ballDirection.y, ballPosition.x, ballDirection.x, remainingTravelDistance, bottom, left, right,
+                                     distance)) {
+            countSubSteps(subStepCount + 1, false);
+            return false;
         }
 
         // Top wall
-        if (segmentSegmentCollisionStatic(ballPosition, ballTravelPath, topLeftCorner, topRightCorner - topLeftCorner, t)) {
-            if (t < minimalT) {
-                minimalT                    = t;
+        if (raySegmentCollisionFixed(ballPosition.y, ballDirection.y, ballPosition.x, ballDirection.x, remainingTravelDistance, top, left, right, distance)) {
+            if (distance < minimalDistance) {
+                minimalDistance             = distance;
                 reflectedDirectionOfClosest = {ballDirection.x, -ballDirection.y};
                 collisionData.type          = CollisionType::WALL;
             }
         }
 
         // Left wall
-        if (segmentSegmentCollisionStatic(ballPosition, ballTravelPath, bottomLeftCorner, topLeftCorner - bottomLeftCorner, t)) {
-            if (t < minimalT) {
-                minimalT                    = t;
+        if (raySegmentCollisionFixed(ballPosition.x, ballDirection.x, ballPosition.y, ballDirection.y, remainingTravelDistance, left, top, bottom, distance)) {
+            if (distance < minimalDistance) {
+                minimalDistance             = distance;
                 reflectedDirectionOfClosest = {-ballDirection.x, ballDirection.y};
                 collisionData.type          = CollisionType::WALL;
             }
         }
 
         // Right wall
-        if (segmentSegmentCollisionStatic(ballPosition, ballTravelPath, bottomRightCorner, topRightCorner - bottomRightCorner, t)) {
-            if (t < minimalT) {
-                minimalT                    = t;
+        if (raySegmentCollisionFixed(ballPosition.x, ballDirection.x, ballPosition.y, ballDirection.y, remainingTravelDistance, right, top, bottom, distance)) {
+            if (distance < minimalDistance) {
+                minimalDistance             = distance;
                 reflectedDirectionOfClosest = {-ballDirection.x, ballDirection.y};
                 collisionData.type          = CollisionType::WALL;
             }
         }
 
         // The pad
-        glm::vec2 latestReflectedDirection;
-        if (rectRectCollisionDynamic(ballPosition, ballScale, ballDirection, remainingTravelDistance, padPosition, padScale, t, latestReflectedDirection)) {
-            if (t < minimalT) {
-                minimalT           = t;
+        if (rectRectCollisionFixed(ballPosition, ballHalfScale, ballDirection, remainingTravelDistance, padPosition, padHalfScale, distance,
+                                   latestReflectedDirection)) {
+            if (distance < minimalDistance) {
+                minimalDistance    = distance;
                 collisionData.type = CollisionType::PAD;
                 if (ballDirection.y == -latestReflectedDirection.y) {
-                    float collisionPoint        = (ballPosition + ballTravelPath * (ballRadius + t)).x;
-                    float padLeftCorner         = padPosition.x - 0.5f * padScale.x + ballRadius;
-                    float hitScale              = (collisionPoint - padLeftCorner) / (padScale.x - 2.0f * ballRadius);
-                    hitScale                    = hitScale * 2.0f - 1.0f;
-                    reflectedDirectionOfClosest = glm::normalize(glm::vec2(hitScale * 1.0f, -1.0f));
+                    // Same hit point as the floating point resolver, so the pad aims the ball the same way in both modes
+                    Fixed pathScale             = fixedMultiply(remainingTravelDistance, ballRadius) + distance;
+                    Fixed collisionPoint        = ballPosition.x + fixedMultiply(ballDirection.x, pathScale);
+                    Fixed padLeftCorner         = padPosition.x - padHalfScale.x + ballRadius;
+                    Fixed hitScale              = fixedDivide(collisionPoint - padLeftCorner, 2 * padHalfScale.x - 2 * ballRadius);
+                    reflectedDirectionOfClosest = fixedNormalize({hitScale * 2 - FIXED_ONE, -FIXED_ONE});
                 } else {
                     reflectedDirectionOfClosest = latestReflectedDirection;
                 }
             }
         }
 
-        // The bricks
-        uint32_t        hitBrickIndex = UINT32_MAX;
-        const uint32_t& brickCount    = level.getTotalBrickCount();
-        for (size_t i = 0; i < brickCount; ++i) {
-            if (bricks[i].health > 0 && circleRectCollisionDynamic(ballPosition, ballRadius, ballDirection, remainingTravelDistance, bricks[i].position,
-                                                                   bricks[i].scale, t, latestReflectedDirection)) {
-                if (t < minimalT) {
-                    minimalT                    = t;
-                    reflectedDirectionOfClosest = latestReflectedDirection;
-                    hitBrickIndex               = static_cast<uint32_t>(i);
-                    collisionData.type          = CollisionType::BRICK;
+        // The bricks, only the alive ones in the grid cells overlapped by the bounding box of the ball sweep, one at a time. Moving rows are swept in their
+        // own frame of reference, the same way as in the floating point resolver
+        uint32_t  hitBrickIndex = UINT32_MAX;
+        FixedVec2 sweepEnd      = {ballPosition.x + fixedMultiply(ballDirection.x, remainingTravelDistance),
+                              ballPosition.y + fixedMultiply(ballDirection.y, remainingTravelDistance)};
+        glm::vec2 sweepMin      = toFloat(FixedVec2{std::min(ballPosition.x, sweepEnd.x) - ballRadius, std::min(ballPosition.y, sweepEnd.y) - ballRadius});
+        glm::vec2 sweepMax      = toFloat(FixedVec2{std::max(ballPosition.x, sweepEnd.x) + ballRadius, std::max(ballPosition.y, sweepEnd.y) + ballRadius});
+        uint64_t  rows, columnsInPath;
+        if (getSweepCells(brickGrid, ball, sweepMin, sweepMax, rows, columnsInPath)) {
+            Fixed remainingFraction = fixedDivide(remainingTravelDistance, travelDistance);
+            rows &= bricks.aliveRows;
+            while (rows != 0) {
+                uint32_t row = countTrailingZeros(rows);
+                rows &= rows - 1;
+
+                FixedVec2 sweepStart     = ballPosition;
+                FixedVec2 sweepDirection = ballDirection;
+                Fixed     sweepDistance  = remainingTravelDistance;
+                Fixed     rowPath        = 0;
+                uint64_t  columns        = bricks.aliveColumns[row] & columnsInPath;
+                bool      movingRow      = bricks.movingRows & (1ull << row);
+                if (movingRow) {
+                    rowPath = fixedMultiply(bricks.rowDisplacements[row], remainingFraction);
+
+                    // The squared length keeps all 32 fractional bits of the products, as in fixedNormalize
+                    FixedVec2 relativePath  = {sweepEnd.x - ballPosition.x - rowPath, sweepEnd.y - ballPosition.y};
+                    uint64_t  squaredLength = static_cast<uint64_t>(relativePath.x * relativePath.x + relativePath.y * relativePath.y);
+                    sweepDistance           = static_cast<Fixed>(integerSqrt(squaredLength));
+                    if (sweepDistance == 0) {
+                        continue;
+                    }
+                    sweepDirection = {fixedDivide(relativePath.x, sweepDistance), fixedDivide(relativePath.y, sweepDistance)};
+                    sweepStart     = {ballPosition.x - (bricks.rowOffsets[row] + bricks.rowDisplacements[row] - rowPath), ballPosition.y};
+
+                    uint32_t rowFirstColumn, rowLastColumn;
+                    if (!getOverlappedColumns(brickGrid, toFloat(std::min(sweepStart.x, sweepStart.x + relativePath.x) - ballRadius),
+                                              toFloat(std::max(sweepStart.x, sweepStart.x + relativePath.x) + ballRadius), rowFirstColumn, rowLastColumn)) {
+                        continue;
+                    }
+                    columns = bricks.aliveColumns[row] & BIT_RANGE(rowFirstColumn, rowLastColumn);
+                }
+
+                while (columns != 0) {
+                    uint32_t brick = row * brickGrid.columnCount + countTrailingZeros(columns);
+                    columns &= columns - 1;
+
+                    FixedVec2 brickCenter         = {toFixed(bricks.x[brick]), toFixed(bricks.y[brick])};
+                    FixedVec2 brickHalfDimensions = {toFixed(bricks.halfWidth[brick]), toFixed(bricks.halfHeight[brick])};
+                    if (!circleRectCollisionFixed(sweepStart, ballRadius, sweepDirection, sweepDistance, brickCenter, brickHalfDimensions, distance,
+                                                  latestReflectedDirection)) {
+                        continue;
+                    }
+
+                    // Distances along the relative path are scaled back to the path of the ball, and the reflection is carried along by the row
+                    if (movingRow) {
+                        distance                 = distance * remainingTravelDistance / sweepDistance;
+                        latestReflectedDirection = fixedNormalize({fixedMultiply(latestReflectedDirection.x, sweepDistance) + rowPath,
+                                                                   fixedMultiply(latestReflectedDirection.y, sweepDistance)});
+                    }
+
+                    if (distance < minimalDistance) {
+                        minimalDistance             = distance;
+                        reflectedDirectionOfClosest = latestReflectedDirection;
+                        hitBrickIndex               = brick;
+                        collisionData.type          = CollisionType::BRICK;
+                    }
                 }
             }
         }
 
-        minimalT = minimalT < 1.0f ? minimalT : 1.0f;
+        // Bricks off the grid, found through the spatial hash the same way as in the floating point resolver
+        bricks.freeBricks.query(sweepMin - EPSILON, sweepMax + EPSILON, [&](const uint32_t& brick) {
+            FixedVec2 brickCenter         = {toFixed(bricks.x[brick]), toFixed(bricks.y[brick])};
+            FixedVec2 brickHalfDimensions = {toFixed(bricks.halfWidth[brick]), toFixed(bricks.halfHeight[brick])};
+            if (circleRectCollisionFixed(ballPosition, ballRadius, ballDirection, remainingTravelDistance, brickCenter, brickHalfDimensions, distance,
+                                         latestReflectedDirection) &&
+                distance < minimalDistance) {
+                minimalDistance             = distance;
+                reflectedDirectionOfClosest = latestReflectedDirection;
+                hitBrickIndex               = brick;
+                collisionData.type          = CollisionType::BRICK;
+            }
+        });
 
-        // If anything is hit
+        Fixed distanceTraveled = std::min(minimalDistance, remainingTravelDistance);
+
+        // If anything is hit, back off by the same fraction of the remaining path as the floating point resolver
         if (ballDirection != reflectedDirectionOfClosest) {
-            minimalT -= EPSILON;
-            ballDirection = reflectedDirectionOfClosest;
+            distanceTraveled -= fixedMultiply(remainingTravelDistance, FIXED_EPSILON);
         }
 
-        ballPosition += ballTravelPath * minimalT;
-        float distanceTraveled = remainingTravelDistance * minimalT;
+        ballPosition.x += fixedMultiply(ballDirection.x, distanceTraveled);
+        ballPosition.y += fixedMultiply(ballDirection.y, distanceTraveled);
         remainingTravelDistance -= distanceTraveled;
+        ballDirection = reflectedDirectionOfClosest;
 
         if (collisionData.type == CollisionType::BRICK) {
             collisionData.hitBrickIndex = hitBrickIndex;
+            collisionData.brickTypeId   = instances[BRICK_START_INDEX + hitBrickIndex].id;
         }
 
         if (collisionData.type != CollisionType::NONE) {
-            collisionInfo.push_back(collisionData);
+            collisionData.ballIndex = ball;
+            collisionEvents.push(collisionData);
         }
     }
 
-    return LevelState::STILL_ALIVE;
+    // Out of sub-steps, the ball waits for the next frame, kept inside the walls the same way as in the floating point resolver
+    bool budgetReached = remainingTravelDistance > 0;
+    if (budgetReached) {
+        ballPosition.x = std::clamp(ballPosition.x, left, right);
+        ballPosition.y = std::max(ballPosition.y, top);
+    }
+    countSubSteps(subStepCount, budgetReached);
+
+    return true;
+}
+
+bool Physics::wallBoxCollision(const glm::vec2& start, const glm::vec2& travelPath, const glm::vec2& boxMin, const glm::vec2& boxMax, float& t,
+                               bool& sideWall) {
+    // Inside the box, only the wall ahead on either axis can be reached, one division per axis finds when
+    float sideT     = 2.0f;
+    float verticalT = 2.0f;
+    if (travelPath.x != 0.0f) {
+        float exitT = ((travelPath.x > 0.0f ? boxMax.x : boxMin.x) - start.x) / travelPath.x;
+        sideT       = exitT >= 0.0f && exitT <= 1.0f ? exitT : 2.0f;
+    }
+    if (travelPath.y != 0.0f) {
+        float exitT = ((travelPath.y > 0.0f ? boxMax.y : boxMin.y) - start.y) / travelPath.y;
+        verticalT   = exitT >= 0.0f && exitT <= 1.0f ? exitT : 2.0f;
+    }
+
+    // Ties go to the top or bottom wall
+    if (verticalT <= 1.0f && verticalT <= sideT) {
+        t        = verticalT;
+        sideWall = false;
+        return true;
+    }
+
+    if (sideT <= 1.0f) {
+        t        = sideT;
+        sideWall = true;
+        return true;
+    }
+
+    return false;
+}
+
+void Physics::findBallCells(Level& level) {
+    const BrickGrid& grid = level.getBrickGrid();
+    for (uint32_t ball = 0; ball < level.getBallCount(); ++ball) {
+        BallCells& cells = m_ballCells[ball];
+        uint32_t   firstRow, lastRow, firstColumn, lastColumn;
+        if (level.isBallActive(ball) && getOverlappedCells(grid, cells.sweepMin, cells.sweepMax, firstRow, lastRow, firstColumn, lastColumn)) {
+            cells.rows    = BIT_RANGE(firstRow, lastRow);
+            cells.columns = BIT_RANGE(firstColumn, lastColumn);
+        } else {
+            cells.rows    = 0;
+            cells.columns = 0;
+        }
+    }
+}
+
+bool Physics::getSweepCells(const BrickGrid& grid, const uint32_t& ball, const glm::vec2& sweepMin, const glm::vec2& sweepMax, uint64_t& rows,
+                            uint64_t& columns) {
+    // A sweep inside the first one overlaps a subset of its cells, testing the bricks of the rest finds no collision
+    const BallCells& cells = m_ballCells[ball];
+    if (sweepMin.x >= cells.sweepMin.x && sweepMin.y >= cells.sweepMin.y && sweepMax.x <= cells.sweepMax.x && sweepMax.y <= cells.sweepMax.y) {
+        rows    = cells.rows;
+        columns = cells.columns;
+        return rows != 0;
+    }
+
+    uint32_t firstRow, lastRow, firstColumn, lastColumn;
+    if (!getOverlappedCells(grid, sweepMin, sweepMax, firstRow, lastRow, firstColumn, lastColumn)) {
+        return false;
+    }
+    rows    = BIT_RANGE(firstRow, lastRow);
+    columns = BIT_RANGE(firstColumn, lastColumn);
+    return true;
+}
+
+bool Physics::getOverlappedCells(const BrickGrid& grid, const glm::vec2& boxMin, const glm::vec2& boxMax, uint32_t& firstRow, uint32_t& lastRow,
+                                 uint32_t& firstColumn, uint32_t& lastColumn) {
+    if (grid.rowCount == 0 || grid.columnCount == 0) {
+        return false;
+    }
+
+    if (m_linearScan) {
+        firstRow    = 0;
+        lastRow     = grid.rowCount - 1;
+        firstColumn = 0;
+        lastColumn  = grid.columnCount - 1;
+        return true;
+    }
+
+    // Cells are indexed from the grid origin, the box is padded so that touching a cell border still counts as an overlap
+    glm::vec2 firstCell = glm::floor((boxMin - EPSILON - grid.origin) / grid.cellDimensions);
+    glm::vec2 lastCell  = glm::floor((boxMax + EPSILON - grid.origin) / grid.cellDimensions);
+
+    if (lastCell.x < 0.0f || lastCell.y < 0.0f || firstCell.x >= grid.columnCount || firstCell.y >= grid.rowCount) {
+        return false;
+    }
+
+    firstColumn = static_cast<uint32_t>(std::max(firstCell.x, 0.0f));
+    firstRow    = static_cast<uint32_t>(std::max(firstCell.y, 0.0f));
+    lastColumn  = std::min(static_cast<uint32_t>(lastCell.x), grid.columnCount - 1);
+    lastRow     = std::min(static_cast<uint32_t>(lastCell.y), grid.rowCount - 1);
+
+    return true;
+}
+
+bool Physics::getOverlappedColumns(const BrickGrid& grid, const float& spanMin, const float& spanMax, uint32_t& firstColumn, uint32_t& lastColumn) {
+    if (grid.columnCount == 0) {
+        return false;
+    }
+
+    if (m_linearScan) {
+        firstColumn = 0;
+        lastColumn  = grid.columnCount - 1;
+        return true;
+    }
+
+    // Padded like the boxes in getOverlappedCells
+    float firstCell = std::floor((spanMin - EPSILON - grid.origin.x) / grid.cellDimensions.x);
+    float lastCell  = std::floor((spanMax + EPSILON - grid.origin.x) / grid.cellDimensions.x);
+
+    if (lastCell < 0.0f || firstCell >= grid.columnCount) {
+        return false;
+    }
+
+    firstColumn = static_cast<uint32_t>(std::max(firstCell, 0.0f));
+    lastColumn  = std::min(static_cast<uint32_t>(lastCell), grid.columnCount - 1);
+
+    return true;
 }
 
 bool Physics::rectRectCollisionDynamic(const glm::vec2& travelingRectCenter, const glm::vec2& travelingRectDimensions,
                                        const glm::vec2& travelingRectNormalizedTravelDirection, const float& travelingRectDistanceTraveled,
                                        const glm::vec2& stationaryRectCenter, const glm::vec2& stationaryRectDimensions, float& t,
                                        glm::vec2& travelingRectNormalizedReflectedCollisionDirection) {
+    glm::vec2 velocity     = travelingRectNormalizedTravelDirection * travelingRectDistanceTraveled;
+    glm::vec2 minkowskiMax = stationaryRectCenter + stationaryRectDimensions * 0.5f + travelingRectDimensions * 0.5f;
+    glm::vec2 minkowskiMin = stationaryRectCenter - stationaryRectDimensions * 0.5f - travelingRectDimensions * 0.5f;
+
+    float nearX, farX, nearY, farY;
+    if (!raySlabIntersection(travelingRectCenter.x, velocity.x, minkowskiMin.x, minkowskiMax.x, nearX, farX) ||
+        !raySlabIntersection(travelingRectCenter.y, velocity.y, minkowskiMin.y, minkowskiMax.y, nearY, farY)) {
+        return false;
+    }
+
+    float enterT = std::max(nearX, nearY);
+    float exitT  = std::min(farX, farY);
+    if (enterT > exitT || enterT > 1.0f || exitT < 0.0f) {
+        return false;
+    }
+
+    // Starting inside the box, the edge tests find where the rectangle leaves it
+    if (enterT < 0.0f) {
+        return rectRectCollisionEdges(travelingRectCenter, travelingRectDimensions, travelingRectNormalizedTravelDirection, travelingRectDistanceTraveled,
+                                      stationaryRectCenter, stationaryRectDimensions, t, travelingRectNormalizedReflectedCollisionDirection);
+    }
+
+    // The box is entered through the face of the slab entered last, ties count as the top or bottom face
+    t = enterT;
+    if (nearX > nearY) {
+        travelingRectNormalizedReflectedCollisionDirection = {-travelingRectNormalizedTravelDirection.x, travelingRectNormalizedTravelDirection.y};
+    } else {
+        travelingRectNormalizedReflectedCollisionDirection = {travelingRectNormalizedTravelDirection.x, -travelingRectNormalizedTravelDirection.y};
+    }
+    return true;
+}
+
+bool Physics::circleRectCollisionDynamic(const glm::vec2& circleCenter, const float& circleRadius, const glm::vec2& circleNormalizedTravelDirection,
+                                         const float& circleDistanceTraveled, const glm::vec2& rectCenter, const glm::vec2& rectDimensions, float& t,
+                                         glm::vec2& circleNormalizedReflectedCollisionDirection) {
+    glm::vec2 velocity     = circleNormalizedTravelDirection * circleDistanceTraveled;
+    glm::vec2 max          = rectCenter + rectDimensions * 0.5f;
+    glm::vec2 min          = rectCenter - rectDimensions * 0.5f;
+    glm::vec2 minkowskiMax = max + circleRadius;
+    glm::vec2 minkowskiMin = min - circleRadius;
+
+    float nearX, farX, nearY, farY;
+    if (!raySlabIntersection(circleCenter.x, velocity.x, minkowskiMin.x, minkowskiMax.x, nearX, farX) ||
+        !raySlabIntersection(circleCenter.y, velocity.y, minkowskiMin.y, minkowskiMax.y, nearY, farY)) {
+        return false;
+    }
+
+    float enterT = std::max(nearX, nearY);
+    float exitT  = std::min(farX, farY);
+    if (enterT > exitT || enterT > 1.0f || exitT < 0.0f) {
+        return false;
+    }
+
+    // Starting inside the box, the edge tests find where the circle leaves the rounded rectangle
+    if (enterT < 0.0f) {
+        return circleRectCollisionEdges(circleCenter, circleRadius, circleNormalizedTravelDirection, circleDistanceTraveled, rectCenter, rectDimensions, t,
+                                        circleNormalizedReflectedCollisionDirection);
+    }
+
+    // Entering the box along a face of the rectangle is a hit on that face
+    glm::vec2 entry = circleCenter + velocity * enterT;
+    if (nearX > nearY) {
+        if (entry.y >= min.y && entry.y <= max.y) {
+            t                                           = enterT;
+            circleNormalizedReflectedCollisionDirection = {-circleNormalizedTravelDirection.x, circleNormalizedTravelDirection.y};
+            return true;
+        }
+    } else if (entry.x >= min.x && entry.x <= max.x) {
+        t                                           = enterT;
+        circleNormalizedReflectedCollisionDirection = {circleNormalizedTravelDirection.x, -circleNormalizedTravelDirection.y};
+        return true;
+    }
+
+    // Otherwise the box is entered next to a corner, and the circle around that corner is the only part of the rounded rectangle left to hit
+    glm::vec2 corner = {std::min(std::max(entry.x, min.x), max.x), std::min(std::max(entry.y, min.y), max.y)};
+    float     cornerT;
+    if (!segmentCircleCollisionStatic(circleCenter, velocity, corner, circleRadius, cornerT, circleNormalizedReflectedCollisionDirection)) {
+        return false;
+    }
+
+    t = cornerT;
+    return true;
+}
+
+bool Physics::rectRectCollisionEdges(const glm::vec2& travelingRectCenter, const glm::vec2& travelingRectDimensions,
+                                     const glm::vec2& travelingRectNormalizedTravelDirection, const float& travelingRectDistanceTraveled,
+                                     const glm::vec2& stationaryRectCenter, const glm::vec2& stationaryRectDimensions, float& t,
+                                     glm::vec2& travelingRectNormalizedReflectedCollisionDirection) {
 
     glm::vec2 corner1 = travelingRectCenter + 0.5f * travelingRectDimensions;
     glm::vec2 corner2 = stationaryRectCenter + 0.5f * stationaryRectDimensions;
@@ -229,9 +1021,9 @@ bool Physics::rectRectCollisionDynamic(const glm::vec2& travelingRectCenter, con
     return collisionDetected;
 }
 
-bool Physics::circleRectCollisionDynamic(const glm::vec2& circleCenter, const float& circleRadius, const glm::vec2& circleNormalizedTravelDirection,
-                                         const float& circleDistanceTraveled, const glm::vec2& rectCenter, const glm::vec2& rectDimensions, float& t,
-                                         glm::vec2& circleNormalizedReflectedCollisionDirection) {
+bool Physics::circleRectCollisionEdges(const glm::vec2& circleCenter, const float& circleRadius, const glm::vec2& circleNormalizedTravelDirection,
+                                       const float& circleDistanceTraveled, const glm::vec2& rectCenter, const glm::vec2& rectDimensions, float& t,
+                                       glm::vec2& circleNormalizedReflectedCollisionDirection) {
 
     glm::vec2 rectCorner          = rectCenter + 0.5f * rectDimensions;
     float     rectExscribedRadius = glm::distance(rectCenter, rectCorner);
@@ -344,6 +1136,119 @@ bool Physics::circleRectCollisionDynamic(const glm::vec2& circleCenter, const fl
     return collisionDetected;
 }
 
+uint32_t Physics::circleRectCollisionBatch(const glm::vec2& circleCenter, const float& circleRadius, const glm::vec2& circleNormalizedTravelDirection,
+                                           const float& circleDistanceTraveled, const BrickColliders& rects, const uint32_t& firstRect,
+                                           const uint32_t& laneMask, float& t) {
+    if (laneMask == 0) {
+        return UINT32_MAX;
+    }
+
+    float closestLaneT[PHYSICS_BATCH_WIDTH];
+
+#ifdef BATCH_FLOAT
+    const glm::vec2 ballVelocity = circleNormalizedTravelDirection * circleDistanceTraveled;
+
+    const BATCH_FLOAT zero          = BATCH_SET1(0.0f);
+    const BATCH_FLOAT one           = BATCH_SET1(1.0f);
+    const BATCH_FLOAT two           = BATCH_SET1(2.0f);
+    const BATCH_FLOAT signMask      = BATCH_SET1(-0.0f);
+    const BATCH_FLOAT startX        = BATCH_SET1(circleCenter.x);
+    const BATCH_FLOAT startY        = BATCH_SET1(circleCenter.y);
+    const BATCH_FLOAT velocityX     = BATCH_SET1(ballVelocity.x);
+    const BATCH_FLOAT velocityY     = BATCH_SET1(ballVelocity.y);
+    const BATCH_FLOAT radius        = BATCH_SET1(circleRadius);
+    const BATCH_FLOAT radiusSquared = BATCH_SET1(circleRadius * circleRadius);
+    const float       a             = glm::dot(ballVelocity, ballVelocity);
+    const BATCH_FLOAT fourA         = BATCH_SET1(4.0f * a);
+    const BATCH_FLOAT twoA          = BATCH_SET1(2.0f * a);
+
+    const BATCH_FLOAT centerX    = BATCH_LOAD(&rects.x[firstRect]);
+    const BATCH_FLOAT centerY    = BATCH_LOAD(&rects.y[firstRect]);
+    const BATCH_FLOAT halfWidth  = BATCH_LOAD(&rects.halfWidth[firstRect]);
+    const BATCH_FLOAT halfHeight = BATCH_LOAD(&rects.halfHeight[firstRect]);
+
+    const BATCH_FLOAT maxX = BATCH_ADD(centerX, halfWidth);
+    const BATCH_FLOAT maxY = BATCH_ADD(centerY, halfHeight);
+    const BATCH_FLOAT minX = BATCH_SUB(centerX, halfWidth);
+    const BATCH_FLOAT minY = BATCH_SUB(centerY, halfHeight);
+
+    const BATCH_FLOAT minkowskiMaxX = BATCH_ADD(maxX, radius);
+    const BATCH_FLOAT minkowskiMaxY = BATCH_ADD(maxY, radius);
+    const BATCH_FLOAT minkowskiMinX = BATCH_SUB(minX, radius);
+    const BATCH_FLOAT minkowskiMinY = BATCH_SUB(minY, radius);
+
+    BATCH_FLOAT nearX, farX, nearY, farY;
+    BATCH_FLOAT missed = zero;
+    BATCH_RAY_SLAB(startX, ballVelocity.x, minkowskiMinX, minkowskiMaxX, nearX, farX, missed);
+    BATCH_RAY_SLAB(startY, ballVelocity.y, minkowskiMinY, minkowskiMaxY, nearY, farY, missed);
+
+    // Operands are swapped so that ties resolve like std::max and std::min in the scalar test
+    BATCH_FLOAT enterT        = BATCH_MAX(nearY, nearX);
+    BATCH_FLOAT exitT         = BATCH_MIN(farY, farX);
+    BATCH_FLOAT crossed       = BATCH_ANDNOT(missed, BATCH_AND(BATCH_LE(enterT, exitT), BATCH_AND(BATCH_LE(enterT, one), BATCH_GE(exitT, zero))));
+    uint32_t    reachableMask = laneMask & BATCH_MOVEMASK(crossed);
+
+    if (reachableMask == 0) {
+        return UINT32_MAX;
+    }
+
+    // Entering the box along a face of the rectangle is a hit on that face
+    BATCH_FLOAT entryX  = BATCH_ADD(startX, BATCH_MUL(velocityX, enterT));
+    BATCH_FLOAT entryY  = BATCH_ADD(startY, BATCH_MUL(velocityY, enterT));
+    BATCH_FLOAT xFace   = BATCH_GT(nearX, nearY);
+    BATCH_FLOAT faceHit = BATCH_SELECT(xFace, BATCH_AND(BATCH_GE(entryY, minY), BATCH_LE(entryY, maxY)),
+                                       BATCH_AND(BATCH_GE(entryX, minX), BATCH_LE(entryX, maxX)));
+
+    // Otherwise only the circle around the corner next to the entry point is left to hit
+    BATCH_FLOAT cornerX = BATCH_MIN(maxX, BATCH_MAX(minX, entryX));
+    BATCH_FLOAT cornerY = BATCH_MIN(maxY, BATCH_MAX(minY, entryY));
+    BATCH_FLOAT cornerT;
+    BATCH_FLOAT cornerHit;
+    BATCH_SEGMENT_CIRCLE(startX, startY, velocityX, velocityY, cornerX, cornerY, cornerT, cornerHit);
+
+    BATCH_FLOAT hit = BATCH_AND(crossed, BATCH_OR(faceHit, cornerHit));
+    BATCH_STORE(closestLaneT, BATCH_SELECT(hit, BATCH_SELECT(faceHit, enterT, cornerT), two));
+
+    // Circles starting inside the box of a rectangle are left to the scalar test, which falls back to the edge tests
+    uint32_t  insideMask = reachableMask & BATCH_MOVEMASK(BATCH_LT(enterT, zero));
+    glm::vec2 reflectedDirection;
+    while (insideMask != 0) {
+        const uint32_t lane = countTrailingZeros(insideMask);
+        const uint32_t i    = firstRect + lane;
+        insideMask &= insideMask - 1;
+
+        closestLaneT[lane] = 2.0f;
+        circleRectCollisionDynamic(circleCenter, circleRadius, circleNormalizedTravelDirection, circleDistanceTraveled, {rects.x[i], rects.y[i]},
+                                   {2.0f * rects.halfWidth[i], 2.0f * rects.halfHeight[i]}, closestLaneT[lane], reflectedDirection);
+    }
+#else
+    uint32_t  reachableMask = laneMask;
+    glm::vec2 reflectedDirection;
+    for (uint32_t lane = 0; lane < PHYSICS_BATCH_WIDTH; ++lane) {
+        const uint32_t i   = firstRect + lane;
+        closestLaneT[lane] = 2.0f;
+        if ((laneMask >> lane) & 1u) {
+            circleRectCollisionDynamic(circleCenter, circleRadius, circleNormalizedTravelDirection, circleDistanceTraveled, {rects.x[i], rects.y[i]},
+                                       {2.0f * rects.halfWidth[i], 2.0f * rects.halfHeight[i]}, closestLaneT[lane], reflectedDirection);
+        }
+    }
+#endif
+
+    // Lanes are reduced in brick order, so ties resolve to the same brick as testing the bricks one by one
+    uint32_t closestLane = UINT32_MAX;
+    t                    = 2.0f;
+    for (uint32_t lane = 0; lane < PHYSICS_BATCH_WIDTH; ++lane) {
+        if (((reachableMask >> lane) & 1u) && closestLaneT[lane] < t) {
+            t           = closestLaneT[lane];
+            closestLane = lane;
+        }
+    }
+
+    return closestLane == UINT32_MAX ? UINT32_MAX : firstRect + closestLane;
+}
+
+const uint32_t Physics::getBatchWidth() const { return PHYSICS_BATCH_WIDTH; }
+
 bool Physics::segmentCircleCollisionStatic(const glm::vec2& segmentStart, const glm::vec2& segmentDir, const glm::vec2& circleCenter, const float& circleRadius,
                                            float& t, glm::vec2& reflectedDir) {
     glm::vec2 f = segmentStart - circleCenter;
@@ -356,7 +1261,7 @@ bool Physics::segmentCircleCollisionStatic(const glm::vec2& segmentStart, const
     if (discriminant < 0) {
         return false;
     } else {
-        discriminant = sqrt(discriminant);
+        discriminant = std::sqrt(discriminant);
 
         t = (-b - discriminant) / (2.0f * a);
 
@@ -388,3 +1293,153 @@ bool Physics::segmentSegmentCollisionStatic(const glm::vec2& firstSegmentStart,
 
     return false;
 }
+
+bool Physics::raySlabIntersection(const float& rayStart, const float& rayVelocity, const float& slabMin, const float& slabMax, float& nearT, float& farT) {
+    if (rayVelocity == 0.0f) {
+        nearT = -INFINITY;
+        farT  = INFINITY;
+        return rayStart >= slabMin && rayStart <= slabMax;
+    }
+
+    float inverseVelocity = 1.0f / rayVelocity;
+    nearT                 = ((rayVelocity > 0.0f ? slabMin : slabMax) - rayStart) * inverseVelocity;
+    farT                  = ((rayVelocity > 0.0f ? slabMax : slabMin) - rayStart) * inverseVelocity;
+    return true;
+}
+
+bool Physics::rectRectCollisionFixed(const FixedVec2& travelingRectCenter, const FixedVec2& travelingRectHalfDimensions,
+                                     const FixedVec2& travelingRectNormalizedTravelDirection, const Fixed& travelingRectDistanceTraveled,
+                                     const FixedVec2& stationaryRectCenter, const FixedVec2& stationaryRectHalfDimensions, Fixed& distance,
+                                     FixedVec2& travelingRectNormalizedReflectedCollisionDirection) {
+    const FixedVec2& start     = travelingRectCenter;
+    const FixedVec2& direction = travelingRectNormalizedTravelDirection;
+
+    FixedVec2 minkowskiMin = {stationaryRectCenter.x - stationaryRectHalfDimensions.x - travelingRectHalfDimensions.x,
+                              stationaryRectCenter.y - stationaryRectHalfDimensions.y - travelingRectHalfDimensions.y};
+    FixedVec2 minkowskiMax = {stationaryRectCenter.x + stationaryRectHalfDimensions.x + travelingRectHalfDimensions.x,
+                              stationaryRectCenter.y + stationaryRectHalfDimensions.y + travelingRectHalfDimensions.y};
+
+    distance = INT64_MAX;
+
+    Fixed edgeDistance;
+    bool  collisionDetected = false;
+
+    // Top and bottom edge
+    for (const Fixed& edge : {minkowskiMin.y, minkowskiMax.y}) {
+        if (raySegmentCollisionFixed(start.y, direction.y, start.x, direction.x, travelingRectDistanceTraveled, edge, minkowskiMin.x, minkowskiMax.x,
+                                     edgeDistance) &&
+            edgeDistance < distance) {
+            distance                                           = edgeDistance;
+            collisionDetected                                  = true;
+            travelingRectNormalizedReflectedCollisionDirection = {direction.x, -direction.y};
+        }
+    }
+
+    // Left and right edge
+    for (const Fixed& edge : {minkowskiMin.x, minkowskiMax.x}) {
+        if (raySegmentCollisionFixed(start.x, direction.x, start.y, direction.y, travelingRectDistanceTraveled, edge, minkowskiMin.y, minkowskiMax.y,
+                                     edgeDistance) &&
+            edgeDistance < distance) {
+            distance                                           = edgeDistance;
+            collisionDetected                                  = true;
+            travelingRectNormalizedReflectedCollisionDirection = {-direction.x, direction.y};
+        }
+    }
+
+    return collisionDetected;
+}
+
+bool Physics::circleRectCollisionFixed(const FixedVec2& circleCenter, const Fixed& circleRadius, const FixedVec2& circleNormalizedTravelDirection,
+                                       const Fixed& circleDistanceTraveled, const FixedVec2& rectCenter, const FixedVec2& rectHalfDimensions, Fixed& distance,
+                                       FixedVec2& circleNormalizedReflectedCollisionDirection) {
+    const FixedVec2& start     = circleCenter;
+    const FixedVec2& direction = circleNormalizedTravelDirection;
+
+    // Half width plus half height bounds the exscribed radius without a square root
+    FixedVec2 offset = {rectCenter.x - start.x, rectCenter.y - start.y};
+    Fixed     reach  = circleRadius + circleDistanceTraveled + rectHalfDimensions.x + rectHalfDimensions.y;
+    if (std::abs(offset.x) > reach || std::abs(offset.y) > reach || offset.x * offset.x + offset.y * offset.y > reach * reach) {
+        return false;
+    }
+
+    FixedVec2 min = {rectCenter.x - rectHalfDimensions.x, rectCenter.y - rectHalfDimensions.y};
+    FixedVec2 max = {rectCenter.x + rectHalfDimensions.x, rectCenter.y + rectHalfDimensions.y};
+
+    distance = INT64_MAX;
+
+    Fixed     partDistance;
+    bool      collisionDetected = false;
+    FixedVec2 reflectedDir;
+
+    // Top and bottom edge
+    for (const Fixed& edge : {min.y - circleRadius, max.y + circleRadius}) {
+        if (raySegmentCollisionFixed(start.y, direction.y, start.x, direction.x, circleDistanceTraveled, edge, min.x, max.x, partDistance) &&
+            partDistance < distance) {
+            distance                                    = partDistance;
+            collisionDetected                           = true;
+            circleNormalizedReflectedCollisionDirection = {direction.x, -direction.y};
+        }
+    }
+
+    // Left and right edge
+    for (const Fixed& edge : {min.x - circleRadius, max.x + circleRadius}) {
+        if (raySegmentCollisionFixed(start.x, direction.x, start.y, direction.y, circleDistanceTraveled, edge, min.y, max.y, partDistance) &&
+            partDistance < distance) {
+            distance                                    = partDistance;
+            collisionDetected                           = true;
+            circleNormalizedReflectedCollisionDirection = {-direction.x, direction.y};
+        }
+    }
+
+    // Corners
+    for (const FixedVec2& corner : {min, FixedVec2{max.x, min.y}, FixedVec2{min.x, max.y}, max}) {
+        if (rayCircleCollisionFixed(start, direction, circleDistanceTraveled, corner, circleRadius, partDistance, reflectedDir) && partDistance < distance) {
+            distance                                    = partDistance;
+            collisionDetected                           = true;
+            circleNormalizedReflectedCollisionDirection = reflectedDir;
+        }
+    }
+
+    return collisionDetected;
+}
+
+bool Physics::rayCircleCollisionFixed(const FixedVec2& rayStart, const FixedVec2& rayDirection, const Fixed& rayLength, const FixedVec2& circleCenter,
+                                      const Fixed& circleRadius, Fixed& distance, FixedVec2& reflectedDir) {
+    FixedVec2 f = {rayStart.x - circleCenter.x, rayStart.y - circleCenter.y};
+
+    // The direction is only close to unit length after rounding, so a is kept in the quadratic
+    Fixed a = fixedDot(rayDirection, rayDirection);
+    Fixed b = fixedDot(f, rayDirection);
+    Fixed c = fixedDot(f, f) - fixedMultiply(circleRadius, circleRadius);
+
+    Fixed discriminant = fixedMultiply(b, b) - fixedMultiply(a, c);
+    if (discriminant < 0 || a == 0) {
+        return false;
+    }
+
+    distance = fixedDivide(-b - fixedSqrt(discriminant), a);
+    if (distance < 0 || distance > rayLength) {
+        return false;
+    }
+
+    FixedVec2 normal = fixedNormalize({f.x + fixedMultiply(rayDirection.x, distance), f.y + fixedMultiply(rayDirection.y, distance)});
+    Fixed     scale  = 2 * fixedDot(rayDirection, normal);
+    reflectedDir     = fixedNormalize({rayDirection.x - fixedMultiply(scale, normal.x), rayDirection.y - fixedMultiply(scale, normal.y)});
+    return true;
+}
+
+bool Physics::raySegmentCollisionFixed(const Fixed& rayStart, const Fixed& rayDirection, const Fixed& raySideStart, const Fixed& raySideDirection,
+                                       const Fixed& rayLength, const Fixed& segmentPosition, const Fixed& segmentMin, const Fixed& segmentMax,
+                                       Fixed& distance) {
+    if (rayDirection == 0) {
+        return false;
+    }
+
+    distance = fixedDivide(segmentPosition - rayStart, rayDirection);
+    if (distance < 0 || distance > rayLength) {
+        return false;
+    }
+
+    Fixed crossing = raySideStart + fixedMultiply(raySideDirection, distance);
+    return crossing >= segmentMin && crossing <= segmentMax;
+}
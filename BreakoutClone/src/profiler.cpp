@@ -0,0 +1,141 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+
+/// <summary>
+/// Set by start, read by every zone.
+/// </summary>
+static std::atomic<bool> recording = false;
+
+/// <summary>
+/// Time recording started at, the trace starts at 0 from it.
+/// </summary>
+static std::atomic<uint64_t> startTime = 0;
+
+/// <summary>
+/// Name the calling thread gets in the trace.
+/// </summary>
+static thread_local const char* threadName = "thread";
+
+/// <summary>
+/// Buffer of the calling thread, created when it records its first zone.
+/// </summary>
+static thread_local ProfilerThreadBuffer* threadBuffer = nullptr;
+
+/// <summary>
+/// Guards the list of thread buffers and the collected zones. Recording threads take it only once, to add their buffer.
+/// </summary>
+static std::mutex registryMutex;
+
+/// <summary>
+/// Buffers of all threads that recorded a zone, kept until the process ends so zones of finished threads are still collected.
+/// </summary>
+static std::vector<std::unique_ptr<ProfilerThreadBuffer>> threadBuffers;
+
+/// <summary>
+/// Ring of the zones collected from the thread buffers, indexed by the zone number modulo the capacity, with the id of the thread that recorded them.
+/// </summary>
+static std::vector<std::pair<uint32_t, ProfilerEvent>> collectedEvents;
+
+/// <summary>
+/// Number of zones collected since start, the ones more than PROFILER_TRACE_CAPACITY behind the last were dropped.
+/// </summary>
+static uint64_t collectedCount = 0;
+
+void Profiler::start() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        collectedEvents.resize(PROFILER_TRACE_CAPACITY);
+    }
+
+    startTime = now();
+    recording = true;
+}
+
+const bool Profiler::isRecording() { return recording.load(std::memory_order_relaxed); }
+
+void Profiler::setThreadName(const char* name) { threadName = name; }
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::record(const char* name, const uint64_t& start, const uint64_t& end) {
+    if (!threadBuffer) {
+        std::unique_ptr<ProfilerThreadBuffer> buffer = std::make_unique<ProfilerThreadBuffer>();
+        buffer->threadName                           = threadName;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->threadId = static_cast<uint32_t>(threadBuffers.size());
+        threadBuffer     = buffer.get();
+        threadBuffers.push_back(std::move(buffer));
+    }
+
+    // Collector frees a slot only after it copied the zone out of it
+    const uint64_t writeIndex = threadBuffer->writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - threadBuffer->readIndex.load(std::memory_order_acquire) == PROFILER_BUFFER_CAPACITY) {
+        threadBuffer->droppedCount.store(threadBuffer->droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    threadBuffer->events[writeIndex & (PROFILER_BUFFER_CAPACITY - 1)] = {name, start, end};
+    threadBuffer->writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+void Profiler::collect() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::unique_ptr<ProfilerThreadBuffer>& buffer : threadBuffers) {
+        const uint64_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t       readIndex  = buffer->readIndex.load(std::memory_order_relaxed);
+        for (; readIndex < writeIndex; ++readIndex) {
+            collectedEvents[collectedCount++ & (PROFILER_TRACE_CAPACITY - 1)] = {buffer->threadId, buffer->events[readIndex & (PROFILER_BUFFER_CAPACITY - 1)]};
+        }
+        buffer->readIndex.store(readIndex, std::memory_order_release);
+    }
+}
+
+void Profiler::save(const char* path) {
+    collect();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::ofstream               file(path);
+
+    // Zones overwritten in the full trace count as dropped, the rest are saved oldest first
+    const uint64_t firstEvent   = collectedCount - std::min<uint64_t>(collectedCount, PROFILER_TRACE_CAPACITY);
+    uint64_t       droppedCount = firstEvent;
+
+    // Timestamps are in microseconds, with three decimals they keep the nanoseconds
+    char line[512];
+    file << "{\"traceEvents\": [\n";
+    for (const std::unique_ptr<ProfilerThreadBuffer>& buffer : threadBuffers) {
+        snprintf(line, sizeof(line), "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"%s\"}},\n", buffer->threadId,
+                 buffer->threadName);
+        file << line;
+        droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+    }
+    for (uint64_t i = firstEvent; i < collectedCount; ++i) {
+        const std::pair<uint32_t, ProfilerEvent>& event = collectedEvents[i & (PROFILER_TRACE_CAPACITY - 1)];
+        const uint64_t start = event.second.start - std::min(event.second.start, startTime.load());
+        snprintf(line, sizeof(line), "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %llu.%03llu, \"dur\": %llu.%03llu},\n",
+                 event.second.name, event.first, static_cast<unsigned long long>(start / 1000), static_cast<unsigned long long>(start % 1000),
+                 static_cast<unsigned long long>((event.second.end - event.second.start) / 1000),
+                 static_cast<unsigned long long>((event.second.end - event.second.start) % 1000));
+        file << line;
+    }
+
+    // Process name closes the list, so every event before it can end with a comma
+    snprintf(line, sizeof(line),
+             "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"Breakout\"}}\n], \"otherData\": {\"droppedZones\": %llu}}\n",
+             static_cast<unsigned long long>(droppedCount));
+    file << line;
+
+    if (!file) {
+        char error[512];
+        snprintf(error, sizeof(error), "Failed to write trace at location %s!", path);
+        throw std::runtime_error(error);
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+
+// Number of zones a thread can record before the collector drains them, must be a power of two, zones recorded into a full buffer are dropped
+#define PROFILER_BUFFER_CAPACITY (1 << 14)
+
+// Number of collected zones the trace keeps, must be a power of two, once it is full every collected zone drops the oldest one
+#define PROFILER_TRACE_CAPACITY (1 << 20)
+
+#ifdef BREAKOUT_PROFILE
+#define PROFILER_CONCATENATE_INNER(a, b) a##b
+#define PROFILER_CONCATENATE(a, b)       PROFILER_CONCATENATE_INNER(a, b)
+
+/// Times the rest of the enclosing scope as a zone of the given name, which has to be a string literal
+#define PROFILE_ZONE(name) ProfilerZone PROFILER_CONCATENATE(profilerZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+/// <summary>
+/// Single timed zone, in nanoseconds since the clock's epoch.
+/// </summary>
+struct ProfilerEvent {
+    /// <summary>
+    /// Name of the zone, a string literal.
+    /// </summary>
+    const char* name;
+
+    /// <summary>
+    /// Time the zone was entered.
+    /// </summary>
+    uint64_t start;
+
+    /// <summary>
+    /// Time the zone was left.
+    /// </summary>
+    uint64_t end;
+};
+
+/// <summary>
+/// Zones recorded by a single thread, waiting for the collector. A lock-free single producer single consumer ring, the recording thread never waits for
+/// the collector.
+/// </summary>
+struct ProfilerThreadBuffer {
+    /// <summary>
+    /// Name of the thread in the trace.
+    /// </summary>
+    const char* threadName;
+
+    /// <summary>
+    /// Id of the thread in the trace, threads are numbered in the order they first record a zone.
+    /// </summary>
+    uint32_t threadId;
+
+    /// <summary>
+    /// Number of zones recorded, written only by the recording thread.
+    /// </summary>
+    std::atomic<uint64_t> writeIndex = 0;
+
+    /// <summary>
+    /// Number of zones drained, written only by the collector.
+    /// </summary>
+    std::atomic<uint64_t> readIndex = 0;
+
+    /// <summary>
+    /// Number of zones dropped because the ring was full, written only by the recording thread.
+    /// </summary>
+    std::atomic<uint64_t> droppedCount = 0;
+
+    /// <summary>
+    /// Ring of recorded zones, indexed by the zone number modulo the capacity.
+    /// </summary>
+    ProfilerEvent events[PROFILER_BUFFER_CAPACITY];
+};
+
+/// <summary>
+/// Records the zones timed with PROFILE_ZONE and saves them as a Chrome trace, which Perfetto and chrome://tracing open, with a track per thread and the
+/// zones nested in each other. Every thread records into a buffer of its own without locking, a single thread collects the recorded zones into the trace
+/// by calling collect regularly. The trace keeps the last PROFILER_TRACE_CAPACITY zones in a ring allocated by start, so long sessions do not grow it.
+/// Zones are recorded only between start and the end of the process, and only compiled in with BREAKOUT_PROFILE defined, otherwise PROFILE_ZONE expands
+/// to nothing.
+/// </summary>
+class Profiler {
+  public:
+    /// <summary>
+    /// Allocates the trace and starts recording zones.
+    /// </summary>
+    static void start();
+
+    /// <summary>
+    /// Getter for whether zones are being recorded.
+    /// </summary>
+    /// <returns>True once start was called.</returns>
+    static const bool isRecording();
+
+    /// <summary>
+    /// Names the calling thread in the trace. Has to be called before the thread records its first zone.
+    /// </summary>
+    /// <param name="name">Name of the thread, a string literal.</param>
+    static void setThreadName(const char* name);
+
+    /// <summary>
+    /// Returns the current time of the profiler clock.
+    /// </summary>
+    /// <returns>Time in nanoseconds since the clock's epoch.</returns>
+    static uint64_t now();
+
+    /// <summary>
+    /// Records a zone of the calling thread. Never blocks, the zone is dropped if the thread's buffer is full.
+    /// </summary>
+    /// <param name="name">Name of the zone, a string literal.</param>
+    /// <param name="start">Time the zone was entered.</param>
+    /// <param name="end">Time the zone was left.</param>
+    static void record(const char* name, const uint64_t& start, const uint64_t& end);
+
+    /// <summary>
+    /// Moves the zones recorded by all threads into the trace, freeing their buffers, and drops the oldest zones of the trace once it is full. Never
+    /// allocates. Has to be called by a single thread, often enough for the buffers not to fill up.
+    /// </summary>
+    static void collect();
+
+    /// <summary>
+    /// Collects the recorded zones and saves the trace as Chrome trace event JSON, with the number of zones dropped by full thread buffers or by the full
+    /// trace since start. Has to be called by the thread calling collect.
+    /// </summary>
+    /// <param name="path">Path to save the trace to.</param>
+    static void save(const char* path);
+};
+
+/// <summary>
+/// Times its own lifetime as a zone, created by PROFILE_ZONE.
+/// </summary>
+class ProfilerZone {
+  public:
+    /// <summary>
+    /// Enters the zone.
+    /// </summary>
+    /// <param name="name">Name of the zone, a string literal.</param>
+    ProfilerZone(const char* name) : m_name(name), m_start(Profiler::isRecording() ? Profiler::now() : 0) {}
+
+    /// <summary>
+    /// Leaves the zone and records it, unless recording started while the zone was entered.
+    /// </summary>
+    ~ProfilerZone() {
+        if (m_start != 0) {
+            Profiler::record(m_name, m_start, Profiler::now());
+        }
+    }
+
+  private:
+    /// <summary>
+    /// Name of the zone.
+    /// </summary>
+    const char* m_name;
+
+    /// <summary>
+    /// Time the zone was entered, 0 if zones were not being recorded.
+    /// </summary>
+    uint64_t m_start;
+};
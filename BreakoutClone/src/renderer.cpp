@@ -1,5 +1,6 @@
 #include "renderer.h"
 
+#include "profiler.h"
 #include "sharedStructures.h"
 
 #include "common.h"
@@ -124,6 +125,8 @@ void Renderer::waitIdle() const { vkDeviceWaitIdle(m_device); }
 void Renderer::setWindowTitle(const char* title) { SDL_SetWindowTitle(m_window, title); }
 
 void Renderer::acquireImage() {
+    PROFILE_ZONE("Renderer::acquireImage");
+
     vkWaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
 
     VK_CHECK(vkAcquireNextImageKHR(m_device, m_swapchain->get(), UINT64_MAX, m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &m_currentImageIndex));
@@ -134,13 +137,19 @@ void Renderer::acquireImage() {
     m_imagesInFlight[m_currentImageIndex] = m_inFlightFences[m_currentFrame];
 }
 
-void Renderer::renderAndPresentImage() {
+void Renderer::submitImage() {
+    PROFILE_ZONE("Renderer::submitImage");
+
     vkResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
 
     m_renderSubmitInfo.pWaitSemaphores   = &m_imageAvailableSemaphores[m_currentFrame];
     m_renderSubmitInfo.pCommandBuffers   = &m_renderCommandBuffers[m_currentImageIndex];
     m_renderSubmitInfo.pSignalSemaphores = &m_renderFinishedSemaphores[m_currentFrame];
     VK_CHECK(vkQueueSubmit(m_queue, 1, &m_renderSubmitInfo, m_inFlightFences[m_currentFrame]));
+}
+
+void Renderer::presentImage() {
+    PROFILE_ZONE("Renderer::presentImage");
 
     m_presentInfo.pWaitSemaphores = &m_renderFinishedSemaphores[m_currentFrame];
     m_presentInfo.pImageIndices   = &m_currentImageIndex;
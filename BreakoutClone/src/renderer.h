@@ -13,9 +13,6 @@
 #define VERBOSE  0
 #define INFO     0
 
-#define WINDOW_WIDTH  1920
-#define WINDOW_HEIGHT 1080
-
 #define PI 3.1415926535897932384f
 
 #define VERTEX_BUFFER_BIND_ID   0
@@ -129,9 +126,14 @@ class Renderer {
     void acquireImage();
 
     /// <summary>
-    /// Sends the command buffer to the GPU and starts the rendering process. Instructs the GPU to present image once render is complete.
+    /// Sends the command buffer to the GPU and starts the rendering process.
+    /// </summary>
+    void submitImage();
+
+    /// <summary>
+    /// Instructs the GPU to present the submitted image once render is complete.
     /// </summary>
-    void renderAndPresentImage();
+    void presentImage();
 
     /// <summary>
     /// Records render command buffers with relevant instance data.
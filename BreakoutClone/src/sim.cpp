@@ -0,0 +1,541 @@
+#include "autoplayer.h"
+#include "game.h"
+#include "inputLog.h"
+#include "physics.h"
+#include "stateHashLog.h"
+#include "threadPool.h"
+
+#include "common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+#define DEFAULT_GAMES_PER_LEVEL 100
+#define DEFAULT_MAX_GAME_TIME   10800
+
+// Names of the game states, in the order they are declared
+static const char* GAME_STATE_NAMES[] = {"begin level", "ball attached", "playing", "lose life", "lose game", "restart screen", "win level", "win game"};
+
+// Heap allocations made by the calling thread, counted so that the steady state of the simulation can be checked to allocate nothing
+static thread_local uint64_t allocationCount = 0;
+
+/// <summary>
+/// Replaces the global allocation to count the allocations of every thread.
+/// </summary>
+void* operator new(size_t size) {
+    ++allocationCount;
+    if (void* memory = malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+/// <summary>
+/// Frees memory allocated by the replaced global allocation.
+/// </summary>
+void operator delete(void* memory) noexcept { free(memory); }
+
+/// <summary>
+/// Frees memory allocated by the replaced global allocation.
+/// </summary>
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+
+/// <summary>
+/// Outcome of a single simulated game.
+/// </summary>
+struct GameResult {
+    /// <summary>
+    /// True if all breakable bricks were destroyed.
+    /// </summary>
+    bool cleared = false;
+
+    /// <summary>
+    /// Simulated time spent with the ball on the pad or in play, in microseconds.
+    /// </summary>
+    uint64_t playTime = 0;
+
+    /// <summary>
+    /// Score at the end of the game.
+    /// </summary>
+    uint32_t score = 0;
+
+    /// <summary>
+    /// Number of lives lost.
+    /// </summary>
+    uint32_t livesLost = 0;
+
+    /// <summary>
+    /// Number of times a ball bounced off the pad.
+    /// </summary>
+    uint32_t padBounces = 0;
+
+    /// <summary>
+    /// Number of times a ball bounced off the walls.
+    /// </summary>
+    uint32_t wallBounces = 0;
+
+    /// <summary>
+    /// Number of times a ball bounced off the bricks.
+    /// </summary>
+    uint32_t brickBounces = 0;
+
+    /// <summary>
+    /// Number of heap allocations made by the simulation steps that started and ended with the ball on the pad or in play. Texture lookups are counted
+    /// as allocations, they have no textures to look up here but allocate a key in the windowed game.
+    /// </summary>
+    uint64_t steadyAllocations = 0;
+
+    /// <summary>
+    /// Sub-steps the physics took to move the balls.
+    /// </summary>
+    SubStepStatistics subSteps;
+};
+
+/// <summary>
+/// Results of all games simulated on a single level.
+/// </summary>
+struct LevelStatistics {
+    /// <summary>
+    /// Number of games simulated.
+    /// </summary>
+    uint32_t gameCount = 0;
+
+    /// <summary>
+    /// Number of games in which the level was cleared.
+    /// </summary>
+    uint32_t clearedCount = 0;
+
+    /// <summary>
+    /// Sum of play times of the cleared games, in microseconds.
+    /// </summary>
+    uint64_t completionTimeSum = 0;
+
+    /// <summary>
+    /// Shortest play time of a cleared game, in microseconds.
+    /// </summary>
+    uint64_t completionTimeMin = UINT64_MAX;
+
+    /// <summary>
+    /// Longest play time of a cleared game, in microseconds.
+    /// </summary>
+    uint64_t completionTimeMax = 0;
+
+    /// <summary>
+    /// Sum of the scores of all games.
+    /// </summary>
+    uint64_t scoreSum = 0;
+
+    /// <summary>
+    /// Sum of the lives lost in all games.
+    /// </summary>
+    uint64_t livesLostSum = 0;
+
+    /// <summary>
+    /// Sum of the pad bounces in all games.
+    /// </summary>
+    uint64_t padBounceSum = 0;
+
+    /// <summary>
+    /// Sum of the wall bounces in all games.
+    /// </summary>
+    uint64_t wallBounceSum = 0;
+
+    /// <summary>
+    /// Sum of the brick bounces in all games.
+    /// </summary>
+    uint64_t brickBounceSum = 0;
+
+    /// <summary>
+    /// Sum of the heap allocations of the steady state simulation steps in all games.
+    /// </summary>
+    uint64_t steadyAllocationSum = 0;
+
+    /// <summary>
+    /// Sum of the ball frames resolved in all games.
+    /// </summary>
+    uint64_t ballFrameSum = 0;
+
+    /// <summary>
+    /// Sum of the sub-steps taken in all games.
+    /// </summary>
+    uint64_t subStepSum = 0;
+
+    /// <summary>
+    /// Most sub-steps a single ball took in a single frame of any game.
+    /// </summary>
+    uint32_t subStepMax = 0;
+
+    /// <summary>
+    /// Sum of the ball frames that reached the sub-step budget in all games.
+    /// </summary>
+    uint64_t budgetReachedSum = 0;
+
+    /// <summary>
+    /// Wall clock time spent simulating the games, summed over all threads, in microseconds.
+    /// </summary>
+    uint64_t simulationTime = 0;
+
+    /// <summary>
+    /// Adds the result of a game to the statistics.
+    /// </summary>
+    /// <param name="result">Result of the game.</param>
+    void add(const GameResult& result) {
+        ++gameCount;
+        if (result.cleared) {
+            ++clearedCount;
+            completionTimeSum += result.playTime;
+            completionTimeMin = std::min(completionTimeMin, result.playTime);
+            completionTimeMax = std::max(completionTimeMax, result.playTime);
+        }
+        scoreSum += result.score;
+        livesLostSum += result.livesLost;
+        padBounceSum += result.padBounces;
+        wallBounceSum += result.wallBounces;
+        brickBounceSum += result.brickBounces;
+        steadyAllocationSum += result.steadyAllocations;
+        ballFrameSum += result.subSteps.ballFrameCount;
+        subStepSum += result.subSteps.subStepCount;
+        subStepMax = std::max(subStepMax, result.subSteps.maxBallSubStepCount);
+        budgetReachedSum += result.subSteps.budgetReachedCount;
+    }
+
+    /// <summary>
+    /// Adds the statistics gathered by another thread.
+    /// </summary>
+    /// <param name="other">Statistics to be added.</param>
+    void merge(const LevelStatistics& other) {
+        gameCount += other.gameCount;
+        clearedCount += other.clearedCount;
+        completionTimeSum += other.completionTimeSum;
+        completionTimeMin = std::min(completionTimeMin, other.completionTimeMin);
+        completionTimeMax = std::max(completionTimeMax, other.completionTimeMax);
+        scoreSum += other.scoreSum;
+        livesLostSum += other.livesLostSum;
+        padBounceSum += other.padBounceSum;
+        wallBounceSum += other.wallBounceSum;
+        brickBounceSum += other.brickBounceSum;
+        steadyAllocationSum += other.steadyAllocationSum;
+        ballFrameSum += other.ballFrameSum;
+        subStepSum += other.subStepSum;
+        subStepMax = std::max(subStepMax, other.subStepMax);
+        budgetReachedSum += other.budgetReachedSum;
+        simulationTime += other.simulationTime;
+    }
+};
+
+/// <summary>
+/// Everything a single thread needs to simulate games. Levels hold the mutable game state, so every thread has its own copy.
+/// </summary>
+struct SimulationWorker {
+    /// <summary>
+    /// Thread's own copy of all levels.
+    /// </summary>
+    std::vector<std::unique_ptr<Level>> levels;
+
+    /// <summary>
+    /// Game played on the thread's levels.
+    /// </summary>
+    std::unique_ptr<Game> game;
+
+    /// <summary>
+    /// Statistics gathered by the thread, one entry per level.
+    /// </summary>
+    std::vector<LevelStatistics> statistics;
+};
+
+/// <summary>
+/// Plays a game on a single level until the level is cleared, all lives are lost or the time runs out. The game is played by the autoplayer, the same one
+/// the game plays itself with.
+/// </summary>
+/// <param name="game">Game to be played.</param>
+/// <param name="levelIndex">Index of the level to be played.</param>
+/// <param name="seed">Seed of the random choices made by the player.</param>
+/// <param name="maxTime">Maximum simulated duration of the game in microseconds.</param>
+/// <returns>Outcome of the game.</returns>
+static GameResult playGame(Game& game, const uint32_t& levelIndex, const uint32_t& seed, const uint64_t& maxTime) {
+    const uint32_t tickTime = 1'000'000 / PHYSICS_TICK_RATE;
+
+    game.initializeLevel(START_LIFE_COUNT, 0, levelIndex);
+    game.resetSubStepStatistics();
+
+    Autoplayer autoplayer(seed);
+    GameResult result;
+    GameInput  input;
+    uint64_t   time = 0;
+    while (time < maxTime) {
+        const GameState state = game.getGameState();
+        if (state == GameState::WIN_LEVEL || state == GameState::LOSE_GAME) {
+            result.cleared = state == GameState::WIN_LEVEL;
+            break;
+        }
+
+        autoplayer.play(game, tickTime, input);
+
+        const Level* const level             = game.getCurrentLevel();
+        const uint64_t     allocationsBefore = allocationCount + level->getTextureLookupCount();
+        game.tick(tickTime, input);
+        time += tickTime;
+        if (state == GameState::BALL_ATTACHED || state == GameState::PLAYING) {
+            result.playTime += tickTime;
+            if (game.getGameState() == state) {
+                result.steadyAllocations += allocationCount + level->getTextureLookupCount() - allocationsBefore;
+            }
+        }
+
+        const CollisionEventRing& collisionEvents = game.getCollisionEvents();
+        for (uint32_t i = 0; i < collisionEvents.getCount(); ++i) {
+            switch (collisionEvents[i].type) {
+                case CollisionType::PAD:
+                    ++result.padBounces;
+                    break;
+                case CollisionType::WALL:
+                    ++result.wallBounces;
+                    break;
+                case CollisionType::BRICK:
+                    ++result.brickBounces;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (game.getLifeCount() < START_LIFE_COUNT - result.livesLost) {
+            ++result.livesLost;
+        }
+    }
+
+    result.score    = game.getScore();
+    result.subSteps = game.getSubStepStatistics();
+    return result;
+}
+
+/// <summary>
+/// Plays recorded player input back on a game started on the first level, the way the game does it but without waiting for the frames, and reports how
+/// the game ended and how fast it was simulated.
+/// </summary>
+/// <param name="inputLogPath">Path to the input log.</param>
+/// <param name="levelPaths">Paths to the levels the input was recorded on, sorted.</param>
+/// <param name="stateHashLogPath">Path the state hash of every step is saved to, nullptr saves nothing.</param>
+static void replayGame(const char* inputLogPath, const std::vector<std::string>& levelPaths, const char* stateHashLogPath) {
+    InputLog inputLog(inputLogPath);
+    if (inputLog.getLevelCount() != levelPaths.size()) {
+        char error[512];
+        snprintf(error, sizeof(error), "Input log at location %s was recorded on %u levels, %zu levels found!", inputLogPath, inputLog.getLevelCount(),
+                 levelPaths.size());
+        throw std::runtime_error(error);
+    }
+
+    std::vector<std::unique_ptr<Level>> levels;
+    for (const std::string& levelPath : levelPaths) {
+        levels.push_back(std::make_unique<Level>(levelPath.c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, nullptr, nullptr, nullptr));
+    }
+    Game game(levels, inputLog.getPhysicsMode());
+    game.initializeLevel(START_LIFE_COUNT, 0, 0);
+
+    printf("Replaying %llu steps of %s physics\n\n", static_cast<unsigned long long>(inputLog.getTickCount()),
+           inputLog.getPhysicsMode() == PhysicsMode::FIXED_POINT ? "fixed point" : "floating point");
+
+    StateHashLog stateHashLog;
+    GameInput    input;
+    uint64_t     tickCount = 0;
+    const auto   start     = std::chrono::high_resolution_clock::now();
+    while (!game.isQuitRequested() && inputLog.next(input)) {
+        game.tick(inputLog.getTickTime(), input);
+        if (stateHashLogPath) {
+            stateHashLog.record(game.getStateHash());
+        }
+        ++tickCount;
+    }
+    const double totalTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    if (stateHashLogPath) {
+        stateHashLog.save(stateHashLogPath);
+    }
+
+    const SubStepStatistics& subSteps = game.getSubStepStatistics();
+    printf("%llu steps, %.1fs of game time in %.3fs, %.0f steps/s\n", static_cast<unsigned long long>(tickCount),
+           MICROSECONDS_TO_SECONDS(static_cast<double>(tickCount) * inputLog.getTickTime()), totalTime, tickCount / std::max(totalTime, 0.000'001));
+    printf("Ended on %s in state %s with score %u and %u lives\n", std::filesystem::path(levelPaths[game.getCurrentLevelIndex()]).filename().string().c_str(),
+           GAME_STATE_NAMES[static_cast<uint32_t>(game.getGameState())], game.getScore(), game.getLifeCount());
+    printf("Final state hash %016llx\n", static_cast<unsigned long long>(game.getStateHash()));
+    printf("%llu collision events dropped\n", static_cast<unsigned long long>(game.getCollisionEvents().getDroppedCount()));
+    printf("%.3f sub-steps per ball per frame, %u at most, budget of %d reached in %llu ball frames\n",
+           static_cast<double>(subSteps.subStepCount) / std::max<uint64_t>(subSteps.ballFrameCount, 1), subSteps.maxBallSubStepCount, MAX_BALL_SUB_STEPS,
+           static_cast<unsigned long long>(subSteps.budgetReachedCount));
+}
+
+/// <summary>
+/// Prints the command line options.
+/// </summary>
+static void printUsage() {
+    printf("Usage: breakout_sim [options]\n"
+           "  --games <count>      Games simulated per level (default %d)\n"
+           "  --threads <count>    Number of threads, 0 for one per core (default 0)\n"
+           "  --seed <value>       Seed of the simulated players (default 0)\n"
+           "  --max-time <seconds> Simulated time after which a game is given up (default %d)\n"
+           "  --levels <folder>    Folder holding the level files (default .%s)\n"
+           "  --fixed-point        Resolves physics in fixed point math, reproducible on any machine\n"
+           "  --check-allocations  Fails if a simulation step with the ball on the pad or in play allocates heap memory\n"
+           "  --replay <file>      Plays back input recorded by the game with --record instead, in the physics mode it was recorded in\n"
+           "  --hash-log <file>    Saves the state hash of every step of the replay\n"
+           "  --compare-hashes <first> <second>\n"
+           "                       Finds the first step two state hash logs disagree on\n",
+           DEFAULT_GAMES_PER_LEVEL, DEFAULT_MAX_GAME_TIME, LEVEL_FOLDER);
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t    gamesPerLevel    = DEFAULT_GAMES_PER_LEVEL;
+    uint32_t    threadCount      = 0;
+    uint32_t    seed             = 0;
+    uint32_t    maxGameTime      = DEFAULT_MAX_GAME_TIME;
+    std::string levelFolder      = std::filesystem::current_path().string() + LEVEL_FOLDER;
+    PhysicsMode physicsMode      = PhysicsMode::FLOATING_POINT;
+    bool        checkAllocations = false;
+    const char* inputLogPath     = nullptr;
+    const char* stateHashLogPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && !strcmp(argv[i], "--games")) {
+            gamesPerLevel = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--threads")) {
+            threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--seed")) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--max-time")) {
+            maxGameTime = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && !strcmp(argv[i], "--levels")) {
+            levelFolder = argv[++i];
+        } else if (!strcmp(argv[i], "--fixed-point")) {
+            physicsMode = PhysicsMode::FIXED_POINT;
+        } else if (!strcmp(argv[i], "--check-allocations")) {
+            checkAllocations = true;
+        } else if (i + 1 < argc && !strcmp(argv[i], "--replay")) {
+            inputLogPath = argv[++i];
+        } else if (i + 1 < argc && !strcmp(argv[i], "--hash-log")) {
+            stateHashLogPath = argv[++i];
+        } else if (i + 2 < argc && !strcmp(argv[i], "--compare-hashes")) {
+            try {
+                const uint64_t divergence = StateHashLog::findFirstDivergence(argv[i + 1], argv[i + 2]);
+                if (divergence == STATE_HASH_LOG_NO_DIVERGENCE) {
+                    printf("State hash logs agree on every step\n");
+                    return 0;
+                }
+                printf("State hash logs diverge at step %llu\n", static_cast<unsigned long long>(divergence));
+                return 1;
+            } catch (std::runtime_error e) {
+                fprintf(stderr, "%s\n", e.what());
+                return -1;
+            }
+        } else {
+            printUsage();
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    try {
+        std::vector<std::string> levelPaths;
+        for (const auto& file : std::filesystem::directory_iterator(levelFolder)) {
+            if (file.path().extension() == ".xml") {
+                levelPaths.push_back(file.path().string());
+            }
+        }
+        std::sort(levelPaths.begin(), levelPaths.end());
+
+        if (levelPaths.empty()) {
+            char error[512];
+            snprintf(error, sizeof(error), "No levels found in %s!", levelFolder.c_str());
+            throw std::runtime_error(error);
+        }
+
+        if (inputLogPath) {
+            replayGame(inputLogPath, levelPaths, stateHashLogPath);
+            return 0;
+        }
+
+        ThreadPool threadPool(threadCount);
+
+        std::vector<SimulationWorker> workers(threadPool.getThreadCount());
+        for (SimulationWorker& worker : workers) {
+            for (const std::string& levelPath : levelPaths) {
+                worker.levels.push_back(std::make_unique<Level>(levelPath.c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, nullptr, nullptr, nullptr));
+            }
+            worker.game = std::make_unique<Game>(worker.levels, physicsMode);
+            worker.statistics.resize(levelPaths.size());
+        }
+
+        printf("Simulating %u games on each of %zu levels on %u threads\n\n", gamesPerLevel, levelPaths.size(), threadPool.getThreadCount());
+
+        const uint32_t gameCount = gamesPerLevel * static_cast<uint32_t>(levelPaths.size());
+        const auto     start     = std::chrono::high_resolution_clock::now();
+
+        threadPool.run(gameCount, [&](const uint32_t& taskIndex, const uint32_t& threadIndex) {
+            SimulationWorker& worker     = workers[threadIndex];
+            const uint32_t    levelIndex = taskIndex / gamesPerLevel;
+
+            const auto gameStart = std::chrono::high_resolution_clock::now();
+            GameResult result    = playGame(*worker.game, levelIndex, seed * gameCount + taskIndex, SECONDS_TO_MICROSECONDS(static_cast<uint64_t>(maxGameTime)));
+
+            LevelStatistics& statistics = worker.statistics[levelIndex];
+            statistics.add(result);
+            statistics.simulationTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - gameStart).count();
+        });
+
+        const double totalTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        printf("%-24s %8s %8s %10s %10s %10s %10s %8s %8s %8s %8s %10s\n", "level", "games", "cleared", "time avg", "time min", "time max", "score avg",
+               "lives", "pad", "wall", "brick", "games/s");
+        for (size_t i = 0; i < levelPaths.size(); ++i) {
+            LevelStatistics statistics;
+            for (const SimulationWorker& worker : workers) {
+                statistics.merge(worker.statistics[i]);
+            }
+
+            const double games        = std::max(statistics.gameCount, 1u);
+            const double clearedGames = std::max(statistics.clearedCount, 1u);
+            printf("%-24s %8u %7.1f%% %9.1fs %9.1fs %9.1fs %10.1f %8.2f %8.1f %8.1f %8.1f %10.1f\n",
+                   std::filesystem::path(levelPaths[i]).filename().string().c_str(), statistics.gameCount, 100.0 * statistics.clearedCount / games,
+                   MICROSECONDS_TO_SECONDS(statistics.completionTimeSum / clearedGames),
+                   statistics.clearedCount ? MICROSECONDS_TO_SECONDS(statistics.completionTimeMin) : 0.0f,
+                   MICROSECONDS_TO_SECONDS(statistics.completionTimeMax), statistics.scoreSum / games, statistics.livesLostSum / games,
+                   statistics.padBounceSum / games, statistics.wallBounceSum / games, statistics.brickBounceSum / games,
+                   statistics.gameCount * threadPool.getThreadCount() / std::max(MICROSECONDS_TO_SECONDS(statistics.simulationTime), 0.000'001f));
+        }
+
+        printf("\n%u games in %.2fs, %.1f games/s\n", gameCount, totalTime, gameCount / totalTime);
+
+        LevelStatistics total;
+        for (const SimulationWorker& worker : workers) {
+            for (const LevelStatistics& statistics : worker.statistics) {
+                total.merge(statistics);
+            }
+        }
+        uint64_t droppedEventCount = 0;
+        for (const SimulationWorker& worker : workers) {
+            droppedEventCount += worker.game->getCollisionEvents().getDroppedCount();
+        }
+        printf("%llu heap allocations in steady state simulation steps\n", static_cast<unsigned long long>(total.steadyAllocationSum));
+        printf("%llu collision events dropped\n", static_cast<unsigned long long>(droppedEventCount));
+        printf("%.3f sub-steps per ball per frame, %u at most, budget of %d reached in %llu ball frames\n",
+               static_cast<double>(total.subStepSum) / std::max<uint64_t>(total.ballFrameSum, 1), total.subStepMax, MAX_BALL_SUB_STEPS,
+               static_cast<unsigned long long>(total.budgetReachedSum));
+
+        if (droppedEventCount > 0) {
+            fprintf(stderr, "Collision events were dropped, the games did not follow the rules!\n");
+            return -1;
+        }
+        if (checkAllocations && total.steadyAllocationSum > 0) {
+            fprintf(stderr, "Steady state simulation steps allocated heap memory!\n");
+            return -1;
+        }
+    } catch (std::runtime_error e) {
+        fprintf(stderr, "%s\n", e.what());
+        return -1;
+    }
+
+    return 0;
+}
@@ -4,26 +4,26 @@
 
 SoundManager::SoundManager() { Mix_OpenAudio(44100, AUDIO_S32, 2, 1024); }
 
-void SoundManager::playSound(const std::string& soundId) {
-    auto soundCacheMapEntry = m_sounds.find(soundId);
-    if (soundCacheMapEntry != m_sounds.end()) {
-        Mix_PlayChannel(-1, soundCacheMapEntry->second, 0);
-    } else {
-        Mix_PlayChannel(-1, loadSound(soundId), 0);
+const uint32_t SoundManager::getSoundHandle(const std::string& soundId) {
+    auto soundHandleMapEntry = m_soundHandles.find(soundId);
+    if (soundHandleMapEntry != m_soundHandles.end()) {
+        return soundHandleMapEntry->second;
     }
+
+    std::string path = std::filesystem::current_path().string() + SOUND_FOLDER + soundId;
+
+    const uint32_t soundHandle = static_cast<uint32_t>(m_sounds.size());
+    m_sounds.push_back(Mix_LoadWAV(path.c_str()));
+    m_soundHandles[soundId] = soundHandle;
+    return soundHandle;
 }
 
+void SoundManager::playSound(const uint32_t& soundHandle) { Mix_PlayChannel(-1, m_sounds[soundHandle], 0); }
+
 SoundManager::~SoundManager() {
-    for (auto& entry : m_sounds) {
-        Mix_FreeChunk(entry.second);
+    for (Mix_Chunk* sound : m_sounds) {
+        Mix_FreeChunk(sound);
     }
 
     Mix_CloseAudio();
 }
-
-Mix_Chunk* SoundManager::loadSound(const std::string& soundId) {
-    std::string path = std::filesystem::current_path().string() + SOUND_FOLDER + soundId;
-
-    m_sounds[soundId] = Mix_LoadWAV(path.c_str());
-    return m_sounds[soundId];
-}
\ No newline at end of file
@@ -6,10 +6,6 @@
 
 #define SOUND_FOLDER "\\resources\\sounds\\"
 
-#define SOUND_PAD     "pad.wav"
-#define SOUND_WALL    "wall.wav"
-#define SOUND_WILHELM "wilhelm.wav"
-
 /// <summary>
 /// Class used to manage sounds
 /// </summary>
@@ -19,21 +15,26 @@ class SoundManager {
     ~SoundManager();
 
     /// <summary>
-    /// Plays the requested sound. Loads the sound if not already loaded.
+    /// Returns the handle of the requested sound. If the sound is not yet loaded, loads it.
     /// </summary>
     /// <param name="soundId">Path to the sound relative to the sound folder.</param>
-    void playSound(const std::string& soundId);
+    /// <returns>Handle of the requested sound.</returns>
+    const uint32_t getSoundHandle(const std::string& soundId);
+
+    /// <summary>
+    /// Plays a loaded sound.
+    /// </summary>
+    /// <param name="soundHandle">Handle of the sound, as returned by getSoundHandle.</param>
+    void playSound(const uint32_t& soundHandle);
 
   private:
     /// <summary>
-    /// Loads a sound into memory.
+    /// Map of the handles of all loaded sounds, by their paths.
     /// </summary>
-    /// <param name="soundId">Path to the sound relative to the sound folder.</param>
-    /// <returns>Pointer to sound data.</returns>
-    Mix_Chunk* loadSound(const std::string& soundId);
+    std::map<std::string, uint32_t> m_soundHandles;
 
     /// <summary>
-    /// Map of all loaded sounds.
+    /// Data of all loaded sounds, indexed by their handles.
     /// </summary>
-    std::map<std::string, Mix_Chunk*> m_sounds;
+    std::vector<Mix_Chunk*> m_sounds;
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "stateHashLog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// Magic and version
+#define STATE_HASH_LOG_HEADER_SIZE 8
+
+/// <summary>
+/// Appends a 64 bit value to the buffer, least significant byte first.
+/// </summary>
+/// <param name="buffer">Buffer to be appended to.</param>
+/// <param name="value">Value to be appended.</param>
+static void writeUint64(std::vector<uint8_t>& buffer, const uint64_t& value) {
+    for (uint32_t i = 0; i < sizeof(uint64_t); ++i) {
+        buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+/// <summary>
+/// Open state hash log file, read one hash at a time.
+/// </summary>
+struct StateHashLogReader {
+    /// <summary>
+    /// Opens the log file and checks its header.
+    /// </summary>
+    /// <param name="path">Path to the log file.</param>
+    StateHashLogReader(const char* path) : file(path, std::ios::binary | std::ios::ate) {
+        const std::streamoff size   = file.is_open() ? static_cast<std::streamoff>(file.tellg()) : 0;
+        const uint64_t       header = size >= STATE_HASH_LOG_HEADER_SIZE ? read(0) : 0;
+        if ((header & UINT32_MAX) != STATE_HASH_LOG_MAGIC || (size - STATE_HASH_LOG_HEADER_SIZE) % sizeof(uint64_t) != 0) {
+            char error[512];
+            snprintf(error, sizeof(error), "Failed to read state hash log at location %s!", path);
+            throw std::runtime_error(error);
+        }
+
+        const uint32_t version = static_cast<uint32_t>(header >> 32);
+        if (version != STATE_HASH_LOG_VERSION) {
+            char error[512];
+            snprintf(error, sizeof(error), "State hash log at location %s is of version %u, only version %d is supported!", path, version,
+                     STATE_HASH_LOG_VERSION);
+            throw std::runtime_error(error);
+        }
+
+        tickCount = (size - STATE_HASH_LOG_HEADER_SIZE) / sizeof(uint64_t);
+    }
+
+    /// <summary>
+    /// Reads a 64 bit value stored least significant byte first.
+    /// </summary>
+    /// <param name="offset">Offset of the first byte from the start of the file.</param>
+    /// <returns>The value read.</returns>
+    uint64_t read(const uint64_t& offset) {
+        uint8_t bytes[sizeof(uint64_t)] = {};
+        file.clear();
+        file.seekg(offset);
+        file.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < sizeof(bytes); ++i) {
+            value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    /// <summary>
+    /// Reads the chained hash of a simulation step.
+    /// </summary>
+    /// <param name="tick">Index of the simulation step.</param>
+    /// <returns>Chained hash of the simulation step.</returns>
+    uint64_t readHash(const uint64_t& tick) { return read(STATE_HASH_LOG_HEADER_SIZE + tick * sizeof(uint64_t)); }
+
+    /// <summary>
+    /// Log file.
+    /// </summary>
+    std::ifstream file;
+
+    /// <summary>
+    /// Number of simulation steps in the log.
+    /// </summary>
+    uint64_t tickCount = 0;
+};
+
+void StateHashLog::record(const uint64_t& stateHash) { m_hashes.push_back(hashCombine(getChainedHash(), stateHash)); }
+
+void StateHashLog::save(const char* path) const {
+    std::vector<uint8_t> buffer;
+    buffer.reserve(STATE_HASH_LOG_HEADER_SIZE + m_hashes.size() * sizeof(uint64_t));
+    writeUint64(buffer, STATE_HASH_LOG_MAGIC | static_cast<uint64_t>(STATE_HASH_LOG_VERSION) << 32);
+    for (const uint64_t& hash : m_hashes) {
+        writeUint64(buffer, hash);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    if (!file) {
+        char error[512];
+        snprintf(error, sizeof(error), "Failed to write state hash log at location %s!", path);
+        throw std::runtime_error(error);
+    }
+}
+
+const uint64_t StateHashLog::getTickCount() const { return m_hashes.size(); }
+
+const uint64_t StateHashLog::getChainedHash() const { return m_hashes.empty() ? 0 : m_hashes.back(); }
+
+uint64_t StateHashLog::findFirstDivergence(const char* firstPath, const char* secondPath) {
+    StateHashLogReader first(firstPath);
+    StateHashLogReader second(secondPath);
+
+    // Chaining makes the hashes differ at every step after the first divergent one, so the steps the logs agree on form a prefix
+    uint64_t low  = 0;
+    uint64_t high = std::min(first.tickCount, second.tickCount);
+    while (low < high) {
+        const uint64_t middle = low + (high - low) / 2;
+        if (first.readHash(middle) == second.readHash(middle)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low == first.tickCount && low == second.tickCount ? STATE_HASH_LOG_NO_DIVERGENCE : low;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+// Marks the start of a state hash log file, "BKSH" read as a little endian integer
+#define STATE_HASH_LOG_MAGIC 0x48534B42
+
+// Bumped whenever the layout of the state hash log file changes
+#define STATE_HASH_LOG_VERSION 1
+
+// Returned when two state hash logs do not diverge
+#define STATE_HASH_LOG_NO_DIVERGENCE UINT64_MAX
+
+/// <summary>
+/// Hashes of the simulation state after every simulation step of a run. Each hash is chained with the hashes before it, so once two runs diverge their
+/// logs differ at every later step, and the first divergent step is found by bisecting the logs. Logs are saved as little endian binary files, the chained
+/// hashes one after another after a small header.
+/// </summary>
+class StateHashLog {
+  public:
+    /// <summary>
+    /// Appends the state hash of a simulation step to the log, chained with the hashes of the steps before it.
+    /// </summary>
+    /// <param name="stateHash">Hash of the simulation state after the step.</param>
+    void record(const uint64_t& stateHash);
+
+    /// <summary>
+    /// Saves the log to a file.
+    /// </summary>
+    /// <param name="path">Path to the log file, an existing file is overwritten.</param>
+    void save(const char* path) const;
+
+    /// <summary>
+    /// Getter for the number of recorded simulation steps.
+    /// </summary>
+    /// <returns>Number of recorded simulation steps.</returns>
+    const uint64_t getTickCount() const;
+
+    /// <summary>
+    /// Getter for the chained hash of all the recorded steps.
+    /// </summary>
+    /// <returns>Chained hash of the last recorded step, 0 if nothing was recorded.</returns>
+    const uint64_t getChainedHash() const;
+
+    /// <summary>
+    /// Finds the first simulation step two saved logs disagree on, reading only the hashes the bisection visits from the files.
+    /// </summary>
+    /// <param name="firstPath">Path to the first log file.</param>
+    /// <param name="secondPath">Path to the second log file.</param>
+    /// <returns>Index of the first step with differing hashes, the length of the shorter log if it matches the start of the longer one, or
+    /// STATE_HASH_LOG_NO_DIVERGENCE if the logs are equal.</returns>
+    static uint64_t findFirstDivergence(const char* firstPath, const char* secondPath);
+
+  private:
+    /// <summary>
+    /// Chained hashes of the recorded steps, in the order of the steps.
+    /// </summary>
+    std::vector<uint64_t> m_hashes;
+};
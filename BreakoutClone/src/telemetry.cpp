@@ -0,0 +1,127 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+/// <summary>
+/// Set by requestSave, static so a signal handler can reach it without a telemetry instance.
+/// </summary>
+static std::atomic<bool> saveRequested = false;
+
+/// <summary>
+/// Names of the frame stages in the saved summary, indexed by the stage.
+/// </summary>
+static const char* const stageNames[TELEMETRY_STAGE_COUNT] = {"input", "simulation", "upload", "acquire", "submit", "present", "simulation_frame",
+                                                               "render_frame"};
+
+/// <summary>
+/// Converts nanoseconds to microseconds for the saved summary.
+/// </summary>
+/// <param name="nanoseconds">Time in nanoseconds.</param>
+/// <returns>Time in microseconds.</returns>
+static double toMicroseconds(const uint64_t& nanoseconds) { return nanoseconds / 1000.0; }
+
+void LatencyHistogram::record(const uint64_t& value) {
+    // Single writer, so a plain load and store replace the read-modify-write, readers only need the counts not to tear
+    std::atomic<uint64_t>& count = m_counts[getBucketIndex(std::min<uint64_t>(value, (1ull << HISTOGRAM_RANGE_BITS) - 1))];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed)) {
+        m_max.store(value, std::memory_order_relaxed);
+    }
+}
+
+const uint64_t LatencyHistogram::getCount() const {
+    uint64_t count = 0;
+    for (const std::atomic<uint64_t>& bucketCount : m_counts) {
+        count += bucketCount.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+const uint64_t LatencyHistogram::getMax() const { return m_max.load(std::memory_order_relaxed); }
+
+const uint64_t LatencyHistogram::getPercentile(const double& percentile) const {
+    const uint64_t count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    const uint64_t rank       = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentile / 100.0 * count)), 1);
+    uint64_t       cumulative = 0;
+    for (uint32_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+        cumulative += m_counts[i].load(std::memory_order_relaxed);
+        if (cumulative >= rank) {
+            return std::min(getBucketTop(i), getMax());
+        }
+    }
+
+    // Values recorded while the buckets were summed can leave the rank short of the last bucket
+    return getMax();
+}
+
+uint32_t LatencyHistogram::getBucketIndex(const uint64_t& value) {
+    if (value < (1ull << HISTOGRAM_PRECISION_BITS)) {
+        return static_cast<uint32_t>(value);
+    }
+
+    // Shifting the value down to the precision leaves its top bit set, only the bits below it pick the bucket
+    const uint32_t shift     = highestSetBit(value) + 1 - HISTOGRAM_PRECISION_BITS;
+    const uint32_t halfCount = 1 << (HISTOGRAM_PRECISION_BITS - 1);
+    return (1 << HISTOGRAM_PRECISION_BITS) + (shift - 1) * halfCount + static_cast<uint32_t>(value >> shift) - halfCount;
+}
+
+uint64_t LatencyHistogram::getBucketTop(const uint32_t& bucketIndex) {
+    if (bucketIndex < (1u << HISTOGRAM_PRECISION_BITS)) {
+        return bucketIndex;
+    }
+
+    const uint32_t halfCount = 1 << (HISTOGRAM_PRECISION_BITS - 1);
+    const uint32_t shift     = (bucketIndex - (1 << HISTOGRAM_PRECISION_BITS)) / halfCount + 1;
+    const uint64_t top       = halfCount + (bucketIndex - (1 << HISTOGRAM_PRECISION_BITS)) % halfCount;
+    return ((top + 1) << shift) - 1;
+}
+
+void Telemetry::record(const TelemetryStage& stage, const std::chrono::high_resolution_clock::time_point& start,
+                       const std::chrono::high_resolution_clock::time_point& end) {
+    m_histograms[static_cast<uint32_t>(stage)].record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+}
+
+const LatencyHistogram& Telemetry::getHistogram(const TelemetryStage& stage) const { return m_histograms[static_cast<uint32_t>(stage)]; }
+
+void Telemetry::save(const char* path) const {
+    const std::string pathString = path;
+    const bool        json       = pathString.size() >= 5 && pathString.compare(pathString.size() - 5, 5, ".json") == 0;
+
+    std::ofstream file(path);
+    file << (json ? "{\n" : "stage,count,p50_us,p99_us,p99.9_us,max_us\n");
+    for (uint32_t i = 0; i < TELEMETRY_STAGE_COUNT; ++i) {
+        const LatencyHistogram& histogram = m_histograms[i];
+
+        char line[512];
+        if (json) {
+            snprintf(line, sizeof(line), "  \"%s\": {\"count\": %llu, \"p50_us\": %.3f, \"p99_us\": %.3f, \"p99.9_us\": %.3f, \"max_us\": %.3f}%s\n",
+                     stageNames[i], static_cast<unsigned long long>(histogram.getCount()), toMicroseconds(histogram.getPercentile(50.0)),
+                     toMicroseconds(histogram.getPercentile(99.0)), toMicroseconds(histogram.getPercentile(99.9)), toMicroseconds(histogram.getMax()),
+                     i + 1 < TELEMETRY_STAGE_COUNT ? "," : "");
+        } else {
+            snprintf(line, sizeof(line), "%s,%llu,%.3f,%.3f,%.3f,%.3f\n", stageNames[i], static_cast<unsigned long long>(histogram.getCount()),
+                     toMicroseconds(histogram.getPercentile(50.0)), toMicroseconds(histogram.getPercentile(99.0)),
+                     toMicroseconds(histogram.getPercentile(99.9)), toMicroseconds(histogram.getMax()));
+        }
+        file << line;
+    }
+    if (json) {
+        file << "}\n";
+    }
+
+    if (!file) {
+        char error[512];
+        snprintf(error, sizeof(error), "Failed to write telemetry at location %s!", path);
+        throw std::runtime_error(error);
+    }
+}
+
+void Telemetry::requestSave() { saveRequested = true; }
+
+const bool Telemetry::takeSaveRequest() { return saveRequested.exchange(false); }
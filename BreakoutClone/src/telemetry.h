@@ -0,0 +1,129 @@
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+#include <chrono>
+
+// Values are told apart to this many bits, so a reported value is never more than 1 / 2^(bits - 1) larger than the recorded one, under 1%
+#define HISTOGRAM_PRECISION_BITS 8
+
+// Values from 2^bits up, in nanoseconds about 18 minutes, are counted in the last bucket
+#define HISTOGRAM_RANGE_BITS 40
+
+// Values below 2^HISTOGRAM_PRECISION_BITS get a bucket each, every higher power of two is split into half as many buckets
+#define HISTOGRAM_BUCKET_COUNT ((1 << HISTOGRAM_PRECISION_BITS) + (HISTOGRAM_RANGE_BITS - HISTOGRAM_PRECISION_BITS) * (1 << (HISTOGRAM_PRECISION_BITS - 1)))
+
+// Number of stages of a frame timed by the telemetry
+#define TELEMETRY_STAGE_COUNT 8
+
+/// <summary>
+/// Stages of a frame timed by the telemetry. The first two are timed on the simulation thread, the next four on the render thread, the last two are the
+/// times between the starts of consecutive frames of either thread.
+/// </summary>
+enum class TelemetryStage { INPUT, SIMULATION, UPLOAD, ACQUIRE, SUBMIT, PRESENT, SIMULATION_FRAME, RENDER_FRAME };
+
+/// <summary>
+/// Counts recorded values in buckets whose width grows with the value, like HdrHistogram, so the whole range from nanoseconds to minutes is covered
+/// with the same relative precision in a fixed amount of memory. Recording is a few instructions and never allocates. Values are recorded by a single
+/// thread, any thread may read the histogram while they are.
+/// </summary>
+class LatencyHistogram {
+  public:
+    /// <summary>
+    /// Counts a value. Only a single thread may record into the histogram.
+    /// </summary>
+    /// <param name="value">Value to be counted.</param>
+    void record(const uint64_t& value);
+
+    /// <summary>
+    /// Getter for the number of recorded values.
+    /// </summary>
+    /// <returns>Number of values recorded since the histogram was created.</returns>
+    const uint64_t getCount() const;
+
+    /// <summary>
+    /// Getter for the largest recorded value.
+    /// </summary>
+    /// <returns>Largest value recorded, exactly, 0 if nothing was recorded.</returns>
+    const uint64_t getMax() const;
+
+    /// <summary>
+    /// Returns the value the given percentage of the recorded values are at or below, rounded up to the top of its bucket.
+    /// </summary>
+    /// <param name="percentile">Percentage of the recorded values, from 0.0 to 100.0.</param>
+    /// <returns>Value at the percentile, 0 if nothing was recorded.</returns>
+    const uint64_t getPercentile(const double& percentile) const;
+
+  private:
+    /// <summary>
+    /// Number of values counted in each bucket.
+    /// </summary>
+    std::atomic<uint64_t> m_counts[HISTOGRAM_BUCKET_COUNT] = {};
+
+    /// <summary>
+    /// Largest recorded value.
+    /// </summary>
+    std::atomic<uint64_t> m_max = 0;
+
+    /// <summary>
+    /// Returns the bucket a value is counted in.
+    /// </summary>
+    /// <param name="value">Value below 2^HISTOGRAM_RANGE_BITS.</param>
+    /// <returns>Index of the bucket.</returns>
+    static uint32_t getBucketIndex(const uint64_t& value);
+
+    /// <summary>
+    /// Returns the largest value counted in a bucket.
+    /// </summary>
+    /// <param name="bucketIndex">Index of the bucket.</param>
+    /// <returns>Largest value of the bucket.</returns>
+    static uint64_t getBucketTop(const uint32_t& bucketIndex);
+};
+
+/// <summary>
+/// Times the stages of every frame into a histogram per stage, in nanoseconds, so the tail of the frame times can be reported and not only their mean.
+/// The summary of all stages can be saved as CSV or JSON, when the game shuts down or when asked to with a signal.
+/// </summary>
+class Telemetry {
+  public:
+    /// <summary>
+    /// Records the duration of a frame stage. Each stage has to be recorded by a single thread.
+    /// </summary>
+    /// <param name="stage">Timed stage.</param>
+    /// <param name="start">Time the stage started.</param>
+    /// <param name="end">Time the stage ended.</param>
+    void record(const TelemetryStage& stage, const std::chrono::high_resolution_clock::time_point& start,
+                const std::chrono::high_resolution_clock::time_point& end);
+
+    /// <summary>
+    /// Getter for the histogram of a stage.
+    /// </summary>
+    /// <param name="stage">Timed stage.</param>
+    /// <returns>Histogram of the stage durations in nanoseconds.</returns>
+    const LatencyHistogram& getHistogram(const TelemetryStage& stage) const;
+
+    /// <summary>
+    /// Saves the number of frames, the 50th, 99th and 99.9th percentile and the maximum of every stage, in microseconds. Paths ending in .json are saved as
+    /// JSON, the rest as CSV with a header line. Can be called while the stages are recorded.
+    /// </summary>
+    /// <param name="path">Path to save the summary to.</param>
+    void save(const char* path) const;
+
+    /// <summary>
+    /// Asks for the summary to be saved. Only sets a flag, so it is safe to call from a signal handler.
+    /// </summary>
+    static void requestSave();
+
+    /// <summary>
+    /// Checks whether the summary was asked to be saved and clears the request.
+    /// </summary>
+    /// <returns>True if requestSave was called since the last check.</returns>
+    static const bool takeSaveRequest();
+
+  private:
+    /// <summary>
+    /// Histograms of the stage durations, indexed by the stage.
+    /// </summary>
+    LatencyHistogram m_histograms[TELEMETRY_STAGE_COUNT];
+};
@@ -0,0 +1,83 @@
+#include "threadPool.h"
+
+#include <algorithm>
+#include <thread>
+
+ThreadPool::ThreadPool(const uint32_t& threadCount) : m_threadCount(threadCount) {
+    if (m_threadCount == 0) {
+        m_threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (uint32_t i = 0; i < m_threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+}
+
+ThreadPool::~ThreadPool() {}
+
+const uint32_t& ThreadPool::getThreadCount() const { return m_threadCount; }
+
+void ThreadPool::run(const uint32_t& taskCount, const std::function<void(const uint32_t& taskIndex, const uint32_t& threadIndex)>& task) {
+    // Every thread starts with a contiguous range of tasks, uneven task costs are balanced out by stealing
+    for (uint32_t i = 0; i < m_threadCount; ++i) {
+        uint64_t firstTask = static_cast<uint64_t>(taskCount) * i / m_threadCount;
+        uint64_t lastTask  = static_cast<uint64_t>(taskCount) * (i + 1) / m_threadCount;
+        for (uint64_t j = firstTask; j < lastTask; ++j) {
+            m_queues[i]->tasks.push_back(static_cast<uint32_t>(j));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < m_threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::work, this, i, std::cref(task));
+    }
+    work(0, task);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (m_exception) {
+        std::exception_ptr exception = m_exception;
+        m_exception                  = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void ThreadPool::work(const uint32_t& threadIndex, const std::function<void(const uint32_t& taskIndex, const uint32_t& threadIndex)>& task) {
+    uint32_t taskIndex;
+    while (takeTask(threadIndex, taskIndex)) {
+        try {
+            task(taskIndex, threadIndex);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_exceptionMutex);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+        }
+    }
+}
+
+bool ThreadPool::takeTask(const uint32_t& threadIndex, uint32_t& taskIndex) {
+    {
+        WorkQueue&                  queue = *m_queues[threadIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            taskIndex = queue.tasks.back();
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (uint32_t i = 1; i < m_threadCount; ++i) {
+        WorkQueue&                  victim = *m_queues[(threadIndex + i) % m_threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            taskIndex = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
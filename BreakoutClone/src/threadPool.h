@@ -0,0 +1,87 @@
+#pragma once
+
+#include "common.h"
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+/// <summary>
+/// Runs batches of independent tasks on all cores. Every thread owns a queue of task indices and works through it from the back, threads that run out of
+/// work steal from the front of the other queues.
+/// </summary>
+class ThreadPool {
+  public:
+    /// <summary>
+    /// Creates the pool. No threads are started until a batch is run.
+    /// </summary>
+    /// <param name="threadCount">Number of threads to run the tasks on, 0 uses one thread per core.</param>
+    ThreadPool(const uint32_t& threadCount = 0);
+    ~ThreadPool();
+
+    /// <summary>
+    /// Getter for the number of threads the tasks are run on.
+    /// </summary>
+    /// <returns>Number of threads the tasks are run on.</returns>
+    const uint32_t& getThreadCount() const;
+
+    /// <summary>
+    /// Runs the task once for every task index and blocks until all of them are done. The calling thread works on the batch as thread 0. The first
+    /// exception thrown by a task is rethrown once the batch is done.
+    /// </summary>
+    /// <param name="taskCount">Number of tasks in the batch.</param>
+    /// <param name="task">Function taking the task index and the index of the thread running it.</param>
+    void run(const uint32_t& taskCount, const std::function<void(const uint32_t& taskIndex, const uint32_t& threadIndex)>& task);
+
+  private:
+    /// <summary>
+    /// Queue of task indices owned by a single thread.
+    /// </summary>
+    struct WorkQueue {
+        /// <summary>
+        /// Mutex guarding the task indices.
+        /// </summary>
+        std::mutex mutex;
+
+        /// <summary>
+        /// Indices of the tasks still waiting to be run.
+        /// </summary>
+        std::deque<uint32_t> tasks;
+    };
+
+    /// <summary>
+    /// Number of threads the tasks are run on.
+    /// </summary>
+    uint32_t m_threadCount;
+
+    /// <summary>
+    /// Work queues, one per thread.
+    /// </summary>
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+    /// <summary>
+    /// First exception thrown by a task of the current batch.
+    /// </summary>
+    std::exception_ptr m_exception;
+
+    /// <summary>
+    /// Mutex guarding the stored exception.
+    /// </summary>
+    std::mutex m_exceptionMutex;
+
+    /// <summary>
+    /// Runs tasks from the thread's own queue, then from the other queues, until there are no tasks left.
+    /// </summary>
+    /// <param name="threadIndex">Index of the thread, selects its own queue.</param>
+    /// <param name="task">Function taking the task index and the index of the thread running it.</param>
+    void work(const uint32_t& threadIndex, const std::function<void(const uint32_t& taskIndex, const uint32_t& threadIndex)>& task);
+
+    /// <summary>
+    /// Takes the next task index from the thread's own queue, or steals one from another queue.
+    /// </summary>
+    /// <param name="threadIndex">Index of the thread, selects its own queue.</param>
+    /// <param name="taskIndex">Index of the task taken.</param>
+    /// <returns>True if a task was taken, false if all queues are empty.</returns>
+    bool takeTask(const uint32_t& threadIndex, uint32_t& taskIndex);
+};